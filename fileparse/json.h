@@ -1,14 +1,38 @@
 #ifndef JAVASCRIPT_OBJECT_NOTATION_H
 #define JAVASCRIPT_OBJECT_NOTATION_H
 
+/* Strict ISO builds hide posix_madvise used by jparse_file, it
+ * works if this header is included before any system one
+ */
+#if defined(JSON_IMPLEMENTATION) && defined(__STRICT_ANSI__) \
+    && !defined(_POSIX_C_SOURCE) && (defined(__unix__) || defined(__APPLE__))
+#  define _POSIX_C_SOURCE 200112L
+#endif
+
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #define JC_TAB_SIZE     4
 #define JC_INIT_STR_CAP 32
-#define JC_INIT_ARR_CAP 16
-#define JC_INIT_OBJ_CAP 16
 #define JC_NUM_BUF_SIZE 256
+#define JC_RDR_BUF_SIZE 4096
+#define JC_ARENA_BLOCK  65536
+#define JC_MAX_DEPTH    1024
+#define JC_INDEX_CHUNK  4096
+#define JC_WRITE_CHUNK  4096
+#define JC_HASH_MIN     16
+
+/* Functions for memory allocation, all memory handed out
+ * by the library, as by jwrite, is to be released by JC_FREE
+ */
+#if !defined(JC_MALLOC) && !defined(JC_REALLOC) && !defined(JC_FREE)
+#  define JC_MALLOC  malloc
+#  define JC_REALLOC realloc
+#  define JC_FREE    free
+#elif !defined(JC_MALLOC) || !defined(JC_REALLOC) || !defined(JC_FREE)
+#  error "Partial definition for allocation"
+#endif
 
 typedef struct jvalue jvalue_t;
 
@@ -37,8 +61,13 @@ typedef struct jobject {
     size_t count;
 } jobject_t;
 
+/* Bits after 'type' are parser bookkeeping, hand-built value must
+ * have them zero, as an initializer like {JT_NUMBER, {.number = 1}}
+ * or calloc gives, but not malloc
+ */
 struct jvalue {
-    jtype_t type;
+    unsigned type : 8; // jtype_t
+    unsigned      : 24;
     union {
         bool        boolean;
         double      number;
@@ -57,8 +86,158 @@ typedef struct jreader {
 
 jvalue_t* jparse(jreader_t reader);
 jvalue_t* jparse_cstr(const char* string);
+jvalue_t* jparse_buffer(const char* buffer, size_t length);
 jvalue_t* jparse_file(const char* filename);
 
+/* Arena owns all nodes and strings parsed into it, they are
+ * released at once by jarena_reset or jarena_free, never by jfree.
+ * It saves a malloc per node, the most of parse time on big input.
+ * Object keys are interned in it: equal keys of all trees parsed
+ * since the last reset share one string
+ */
+typedef struct jarena jarena_t;
+
+jarena_t* jarena_init(size_t capacity);
+void      jarena_reset(jarena_t* arena);
+void      jarena_free(jarena_t* arena);
+
+jvalue_t* jparse_arena(jarena_t* arena, const char* buffer, size_t length);
+
+/* Like jparse_arena, but strings are decoded in place and point
+ * into 'buffer', so it is overwritten and must outlive the tree
+ */
+jvalue_t* jparse_insitu(jarena_t* arena, char* buffer, size_t length);
+
+/* Options of jparse_flags, which parses into 'arena' or,
+ * if NULL, to free by jfree. With JF_LAZY_NUMBERS number nodes
+ * keep their text, converted on the first jinteger or jnumber
+ * and written out as is, so their 'as' is read only by these.
+ * Range of lazy fractions is not checked, 1e999 reads as inf.
+ * With JF_HASHED_OBJECTS objects of at least JC_HASH_MIN entries
+ * get room for hash index, which the first jat builds
+ */
+typedef enum jflags {
+    JF_LAZY_NUMBERS   = 1,
+    JF_PACKED_ARRAYS  = 2,
+    JF_HASHED_OBJECTS = 4
+} jflags_t;
+
+jvalue_t* jparse_flags(jarena_t* arena, const char* buffer, size_t length, unsigned flags);
+
+/* Context keeps scratch buffers of the parser between calls,
+ * so parsing many documents by one context doesn't allocate
+ * them again. Parser has no global state: threads parse at once
+ * with a context and an arena each
+ */
+typedef struct jcontext jcontext_t;
+
+jcontext_t* jcontext_init(void);
+void        jcontext_free(jcontext_t* context);
+
+jvalue_t* jparse_context(jcontext_t* context, jarena_t* arena,
+    const char* buffer, size_t length, unsigned flags);
+
+/* With JF_PACKED_ARRAYS arrays of only integers or only numbers
+ * keep them in one vector instead of nodes, 'values' of such
+ * array is not to be read and jpath or jqeval don't step into
+ * it. Arrays mixing integers with numbers stay nodes, so every
+ * item keeps its type. jpacked gives JT_INTEGER or JT_NUMBER for
+ * packed array and JT_NULL for any other value, jintegers and
+ * jnumbers give the vector of 'count' items or NULL
+ */
+jtype_t          jpacked  (const jvalue_t* array);
+const long long* jintegers(const jvalue_t* array);
+const double*    jnumbers (const jvalue_t* array);
+
+/* Value of integer or number, converted if needed, 0 for other
+ * types. First access to lazy number writes it, so it must not
+ * race like first jat
+ */
+long long jinteger(jvalue_t* value);
+double    jnumber (jvalue_t* value);
+
+/* Event handlers for jsax, NULL ones are skipped and any handler
+ * returning false stops the parse. Strings and keys are
+ * NUL-terminated and valid only until the handler returns
+ */
+typedef struct jhandler {
+    bool (*object_begin)(void* ctx);
+    bool (*object_end  )(void* ctx);
+    bool (*array_begin )(void* ctx);
+    bool (*array_end   )(void* ctx);
+    bool (*key    )(void* ctx, const char* key, size_t length);
+    bool (*string )(void* ctx, const char* string, size_t length);
+    bool (*integer)(void* ctx, long long integer);
+    bool (*number )(void* ctx, double number);
+    bool (*boolean)(void* ctx, bool boolean);
+    bool (*null   )(void* ctx);
+    void* ctx;
+} jhandler_t;
+
+bool jsax(jreader_t reader, const jhandler_t* handler);
+bool jsax_buffer(const char* buffer, size_t length, const jhandler_t* handler);
+bool jsax_file(const char* filename, const jhandler_t* handler);
+
+/* Push parser takes input in pieces of any size. Top-level
+ * number or keyword ends only with jpush_finish, then completed
+ * value is taken by jpush_value: from 'arena' or, if NULL,
+ * to free by jfree
+ */
+typedef enum jpstatus { JP_MORE, JP_DONE, JP_ERROR } jpstatus_t;
+typedef struct jpush jpush_t;
+
+jpush_t*   jpush_init  (jarena_t* arena);
+jpstatus_t jpush_feed  (jpush_t* push, const char* data, size_t length);
+jpstatus_t jpush_finish(jpush_t* push);
+jvalue_t*  jpush_value (jpush_t* push);
+void       jpush_free  (jpush_t* push);
+
+typedef enum jtoktype {
+    JK_END = 0,
+    JK_ERROR,
+    JK_OBJECT_BEGIN,
+    JK_OBJECT_END,
+    JK_ARRAY_BEGIN,
+    JK_ARRAY_END,
+    JK_COLON,
+    JK_COMMA,
+    JK_NULL,
+    JK_FALSE,
+    JK_TRUE,
+    JK_INTEGER,
+    JK_NUMBER,
+    JK_STRING
+} jtoktype_t;
+
+/* Token text points into the lexed buffer, quotes are not
+ * included in strings and 'escaped' tells if they need decoding
+ */
+typedef struct jtoken {
+    jtoktype_t type;
+    const char* start;
+    size_t length;
+    bool escaped;
+} jtoken_t;
+
+typedef struct jlexer {
+    const char *cur, *end;
+} jlexer_t;
+
+jlexer_t jlexer(const char* buffer, size_t length);
+jtoken_t jlex(jlexer_t* lexer);
+
+/* 'buffer' must hold at least token->length + 1 bytes,
+ * returns length of the decoded NUL-terminated string
+ */
+size_t jtoken_string (const jtoken_t* token, char* buffer);
+bool   jtoken_integer(const jtoken_t* token, long long* integer);
+bool   jtoken_number (const jtoken_t* token, double* number);
+
+/* Entries keep input order and are scanned one by one, unless
+ * object was parsed with JF_HASHED_OBJECTS: then its hash index
+ * is built on the first jat, so first lookups into shared tree
+ * must not race
+ */
 jvalue_t* jat(jvalue_t* object, const char* key);
 
 jvalue_t* jpath(jvalue_t* value, size_t depth, ...);
@@ -66,21 +245,169 @@ jvalue_t* jpath(jvalue_t* value, size_t depth, ...);
 #define ji__arg_count(...) ji__Arg_count(__VA_ARGS__, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, _)
 #define jpath(value, ...) jpath((value), ji__arg_count(__VA_ARGS__), __VA_ARGS__)
 
+/* Follows path like jpath over raw 'buffer' and parses only the
+ * value at its end, into 'arena' or, if NULL, to free by jfree.
+ * Subtrees aside of path are skipped by brackets and quotes,
+ * not validated
+ */
+jvalue_t* jfind(jarena_t* arena, const char* buffer, size_t length, size_t depth, ...);
+#define jfind(arena, buffer, length, ...) jfind((arena), (buffer), (length), \
+    ji__arg_count(__VA_ARGS__), __VA_ARGS__)
+
+/* Path compiled once for many lookups: JSON Pointer "/a/0/b"
+ * or JSONPath subset "$.a[0]['b']". Keys are hashed here,
+ * NULL is returned for bad syntax
+ */
+typedef struct jquery jquery_t;
+
+jquery_t* jqcompile(const char* path);
+jvalue_t* jqeval(const jquery_t* query, jvalue_t* value);
+void      jqfree(jquery_t* query);
+
+/* Checks with no allocation that 'buffer' holds one JSON value
+ * jparse_buffer accepts, so numbers out of range fail as well,
+ * except that nesting is limited by JC_MAX_DEPTH like in jsax.
+ * On failure 'offset', if not NULL, is set to the bad byte
+ * or to the start of bad string or number
+ */
+bool jvalidate(const char* buffer, size_t length, size_t* offset);
+
+/* Binds object straight into struct 'object' by table of its
+ * fields ended by JB_END, no tree is built. Keys absent from the
+ * table are checked and skipped, null leaves field as it is.
+ * Strings and arrays are malloc'd: array field is pointer to
+ * 'size'-byte items, each bound by 'fields[0]', and their count
+ * is size_t at 'count' offset. Object is zeroed before the first
+ * jbind, after any jbind, even failed, jbind_free releases it
+ */
+typedef enum jbtype {
+    JB_END = 0,
+    JB_BOOL,   // bool
+    JB_INT,    // int
+    JB_LLONG,  // long long
+    JB_DOUBLE, // double
+    JB_STRING, // char*
+    JB_OBJECT, // struct bound by 'fields'
+    JB_ARRAY   // items bound by 'fields[0]'
+} jbtype_t;
+
+typedef struct jfield jfield_t;
+struct jfield {
+    const char* name;
+    jbtype_t type;
+    size_t offset;
+    const jfield_t* fields;
+    size_t size, count; // of JB_ARRAY
+};
+
+bool jbind(const char* buffer, size_t length, const jfield_t* fields, void* object);
+void jbind_free(const jfield_t* fields, void* object);
+
 void jprint(jvalue_t* value, unsigned level);
 #define jprint(value) jprint((value), 0)
 
+/* Serializes compact or, when 'pretty', indented like jprint,
+ * numbers by the shortest digits that read back the same.
+ * jwrite returns malloc'd NUL-terminated text and its length,
+ * jwrite_sink is there if memory/sink.h is included before
+ */
+char* jwrite(jvalue_t* value, bool pretty, size_t* length);
+#ifdef SINK_H
+bool jwrite_sink(jvalue_t* value, bool pretty, sink_t* sink);
+#endif
+
+/* Binary form in CBOR (RFC 8949): integers and numbers keep
+ * their type, strings are prefixed by length. Decoder skips tags,
+ * takes half precision and undefined as null, but not byte or
+ * indefinite length strings. Decoded tree goes into 'arena' or,
+ * if NULL, to free by jfree. Sink and stream versions are there
+ * if memory/sink.h and memory/stream.h are included before
+ */
+unsigned char* jcbor_write(jvalue_t* value, size_t* length);
+jvalue_t*      jcbor_parse(jarena_t* arena, const void* buffer, size_t length);
+#ifdef SINK_H
+bool jcbor_write_sink(jvalue_t* value, sink_t* sink);
+#endif
+#ifdef STREAM_H
+jvalue_t* jcbor_parse_stream(jarena_t* arena, stream_t* stream);
+#endif
+
+/* Parsed string node holds its text in the same allocation,
+ * so to change the text the node is replaced
+ */
 void jfree(jvalue_t* value);
 
+/* Flat form of document in one array of words: tag in the top
+ * byte, numbers take one more word, arrays and objects span
+ * up to their closing word and entries are key, then value.
+ * Strings are NUL-terminated in 'strings'
+ */
+typedef struct jtape {
+    uint64_t* words; size_t count;
+    char* strings; size_t length;
+} jtape_t;
+
+/* Node is position in tape, not found one has NULL tape */
+typedef struct jtnode {
+    const jtape_t* tape;
+    size_t at;
+} jtnode_t;
+
+jtape_t* jtape(const char* buffer, size_t length);
+void     jtape_free(jtape_t* tape);
+
+jtnode_t    jtroot   (const jtape_t* tape);
+bool        jtfound  (jtnode_t node);
+jtype_t     jttype   (jtnode_t node);
+bool        jtboolean(jtnode_t node);
+long long   jtinteger(jtnode_t node);
+double      jtnumber (jtnode_t node);
+const char* jtstring (jtnode_t node);
+size_t      jtcount  (jtnode_t node);
+
+/* Children of array or object: entry gives its key and value
+ *     for (jtnode_t it = jtfirst(node); !jtend(it); it = jtnext(it))
+ */
+jtnode_t    jtfirst(jtnode_t node);
+jtnode_t    jtnext (jtnode_t node);
+bool        jtend  (jtnode_t node);
+const char* jtkey  (jtnode_t entry);
+jtnode_t    jtvalue(jtnode_t entry);
+
+jtnode_t jtat   (jtnode_t object, const char* key);
+jtnode_t jtindex(jtnode_t array, size_t index);
+
+jtnode_t jtpath(jtnode_t node, size_t depth, ...);
+#define jtpath(node, ...) jtpath((node), ji__arg_count(__VA_ARGS__), __VA_ARGS__)
+
 #endif /* JAVASCRIPT_OBJECT_NOTATION_H */
 
-#ifdef JSON_IMPLEMENTATION
+#if defined(JSON_IMPLEMENTATION) && !defined(JAVASCRIPT_OBJECT_NOTATION_IMPL)
+#define JAVASCRIPT_OBJECT_NOTATION_IMPL
 
 #include <errno.h>
+#include <float.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define JI_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 static bool jiisspace(int ch) {
     return ch ==  ' ' || ch == '\n'
         || ch == '\t' || ch == '\r';
@@ -108,22 +435,338 @@ static unsigned jifromhex(int digit) {
     return -1;
 }
 
-static void jiskipws(jreader_t rdr) {
-    while (true) {
-        int ch = rdr.peek(rdr.ctx);
-        if (!jiisspace(ch)) break;
-        (void)rdr.next(rdr.ctx);
+typedef struct { char* ptr; size_t len, cap; } jisb_t;
+
+typedef union { long long i; double d; void* p; } jialign_t;
+
+typedef struct jiblock {
+    struct jiblock* prev;
+    char *begin, *end;
+} jiblock_t;
+
+#define JI_ALIGN sizeof(jialign_t)
+#define JI_ALIGN_UP(size) (((size) + JI_ALIGN - 1) & ~(JI_ALIGN - 1))
+
+typedef struct jikey { const char* str; size_t len; unsigned hash; } jikey_t;
+
+struct jarena {
+    jiblock_t* top; size_t capacity;
+    jikey_t* keys; size_t keycount, keycap; // interned keys
+};
+
+jarena_t* jarena_init(size_t cap) {
+    jarena_t* arena = JC_MALLOC(sizeof *arena);
+    if (arena) {
+        memset(arena, 0, sizeof *arena);
+        arena->capacity = cap ? cap : JC_ARENA_BLOCK;
+    } return arena;
+}
+
+static void jiforgetkeys(jarena_t* arena) {
+    if (arena->keys) memset(arena->keys, 0, arena->keycap * sizeof *arena->keys);
+    arena->keycount = 0;
+}
+
+static void jiarenarewind(jarena_t* arena, jiblock_t* top, char* begin) {
+    while (arena->top != top) {
+        jiblock_t* prev = arena->top->prev;
+        JC_FREE(arena->top);
+        arena->top = prev;
     }
+    if (top) top->begin = begin;
 }
 
-typedef struct { char* ptr; size_t len, cap; } jisb_t;
+void jarena_reset(jarena_t* arena) {
+    if (!arena || !arena->top) return;
+    jiblock_t* first = arena->top;
+    while (first->prev) first = first->prev;
+    jiarenarewind(arena, first, (char*)first + JI_ALIGN_UP(sizeof *first));
+    jiforgetkeys(arena);
+}
+
+void jarena_free(jarena_t* arena) {
+    if (arena) {
+        jiarenarewind(arena, NULL, NULL);
+        JC_FREE(arena->keys);
+    } JC_FREE(arena);
+}
+
+static void* jiarenaalloc(jarena_t* arena, size_t size) {
+    jiblock_t* blk = arena->top;
+    size = JI_ALIGN_UP(size);
+    if (!blk || (size_t)(blk->end - blk->begin) < size) {
+        size_t cap = size > arena->capacity ? size : arena->capacity;
+        char* mem = JC_MALLOC(JI_ALIGN_UP(sizeof *blk) + cap);
+        if (!mem) return NULL;
+        blk = (jiblock_t*)(void*)mem;
+        blk->prev  = arena->top;
+        blk->begin = mem + JI_ALIGN_UP(sizeof *blk);
+        blk->end   = blk->begin + cap;
+        arena->top = blk;
+    }
+    void* mem = blk->begin;
+    blk->begin += size;
+    return mem;
+}
+
+static unsigned jihash(const char* key) {
+    unsigned hash = 2166136261u;
+    while (*key) hash = (hash ^ (unsigned char)*key++) * 16777619u;
+    return hash;
+}
+
+static unsigned jihashrun(const char* run, size_t len) {
+    unsigned hash = 2166136261u;
+    while (len --> 0) hash = (hash ^ (unsigned char)*run++) * 16777619u;
+    return hash;
+}
+
+static bool jigrowkeys(jarena_t* arena) {
+    size_t cap = arena->keycap ? arena->keycap * 2 : 64;
+    jikey_t* keys = JC_MALLOC(cap * sizeof *keys);
+    if (!keys) return false;
+    memset(keys, 0, cap * sizeof *keys);
+    for (size_t i = 0; i < arena->keycap; i++) {
+        if (!arena->keys[i].str) continue;
+        size_t slot = arena->keys[i].hash & (cap - 1);
+        while (keys[slot].str) slot = (slot + 1) & (cap - 1);
+        keys[slot] = arena->keys[i];
+    }
+    JC_FREE(arena->keys);
+    arena->keys = keys;
+    arena->keycap = cap;
+    return true;
+}
+
+/* Returns arena copy of key, the same for equal keys */
+static const char* jiintern(jarena_t* arena, const char* key, size_t len) {
+    if (arena->keycount * 2 >= arena->keycap && !jigrowkeys(arena)) {
+        char* str = jiarenaalloc(arena, len + 1);
+        if (str) { memcpy(str, key, len); str[len] = '\0'; }
+        return str;
+    }
+
+    unsigned hash = jihashrun(key, len);
+    size_t mask = arena->keycap - 1, slot = hash & mask;
+    for (; arena->keys[slot].str; slot = (slot + 1) & mask) {
+        jikey_t* k = &arena->keys[slot];
+        if (k->hash == hash && k->len == len && memcmp(k->str, key, len) == 0)
+            return k->str;
+    }
+
+    char* str = jiarenaalloc(arena, len + 1);
+    if (!str) return NULL;
+    memcpy(str, key, len);
+    str[len] = '\0';
+    arena->keys[slot].str = str;
+    arena->keys[slot].len = len;
+    arena->keys[slot].hash = hash;
+    arena->keycount++;
+    return str;
+}
+
+/* Stage 1 classifies flat input in 64-byte blocks, a bit of
+ * each mask per byte, and marks structural positions: operators
+ * and opening quotes outside of strings, and the first byte of
+ * every scalar. The parser walks them instead of whitespace
+ */
+typedef struct jistage1 {
+    const unsigned char *begin, *limit, *end; // indexed chunk
+    unsigned short* index; size_t count, at;
+    uint64_t escaped, instring, scalar; // carried between blocks
+} jistage1_t;
+
+static void jiclassify(const unsigned char* block,
+    uint64_t* quote, uint64_t* bslash, uint64_t* op, uint64_t* space) {
+#if defined(__AVX2__)
+    for (int i = 0; i < 64; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(const void*)(block + i));
+        #define jieq(ch) _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ch))
+        __m256i o = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(jieq('{'), jieq('}')), _mm256_or_si256(jieq('['), jieq(']'))),
+            _mm256_or_si256(jieq(':'), jieq(',')));
+        __m256i w = _mm256_or_si256(
+            _mm256_or_si256(jieq(' '), jieq('\n')), _mm256_or_si256(jieq('\t'), jieq('\r')));
+        *quote  |= (uint64_t)(uint32_t)_mm256_movemask_epi8(jieq('"' )) << i;
+        *bslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(jieq('\\')) << i;
+        *op     |= (uint64_t)(uint32_t)_mm256_movemask_epi8(o) << i;
+        *space  |= (uint64_t)(uint32_t)_mm256_movemask_epi8(w) << i;
+        #undef jieq
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (int i = 0; i < 64; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(const void*)(block + i));
+        #define jieq(ch) _mm_cmpeq_epi8(v, _mm_set1_epi8(ch))
+        __m128i o = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(jieq('{'), jieq('}')), _mm_or_si128(jieq('['), jieq(']'))),
+            _mm_or_si128(jieq(':'), jieq(',')));
+        __m128i w = _mm_or_si128(
+            _mm_or_si128(jieq(' '), jieq('\n')), _mm_or_si128(jieq('\t'), jieq('\r')));
+        *quote  |= (uint64_t)(uint16_t)_mm_movemask_epi8(jieq('"' )) << i;
+        *bslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(jieq('\\')) << i;
+        *op     |= (uint64_t)(uint16_t)_mm_movemask_epi8(o) << i;
+        *space  |= (uint64_t)(uint16_t)_mm_movemask_epi8(w) << i;
+        #undef jieq
+    }
+#else
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch (block[i]) {
+            case '"' : *quote  |= bit; break;
+            case '\\': *bslash |= bit; break;
+            case '{': case '}': case '[':
+            case ']': case ':': case ',': *op |= bit; break;
+            case ' ': case '\n': case '\t': case '\r': *space |= bit; break;
+        }
+    }
+#endif
+}
+
+static uint64_t jiprefixxor(uint64_t bits) {
+    bits ^= bits <<  1; bits ^= bits <<  2;
+    bits ^= bits <<  4; bits ^= bits <<  8;
+    bits ^= bits << 16; bits ^= bits << 32;
+    return bits;
+}
+
+static uint64_t jistructurals(jistage1_t* s1, const unsigned char* block) {
+    const uint64_t even = 0x5555555555555555ull, odd = ~even;
+    uint64_t quote = 0, bslash = 0, op = 0, space = 0;
+    jiclassify(block, &quote, &bslash, &op, &space);
+
+    /* escaped bytes end odd-length runs of backslashes */
+    uint64_t starts = bslash & ~(bslash << 1);
+    uint64_t even_mask = even ^ s1->escaped;
+    uint64_t even_carries = bslash + (starts & even_mask);
+    uint64_t odd_carries  = bslash + (starts & ~even_mask);
+    uint64_t carry = odd_carries < bslash;
+    odd_carries |= s1->escaped;
+    s1->escaped = carry;
+    uint64_t escaped = (even_carries & ~bslash & odd)
+                     | (odd_carries  & ~bslash & even);
+
+    quote &= ~escaped;
+    uint64_t instring = jiprefixxor(quote) ^ s1->instring;
+    s1->instring = 0 - (instring >> 63);
+
+    uint64_t pred = (op & ~instring) | quote | space;
+    uint64_t scalar = (pred << 1 | s1->scalar) & ~space & ~instring;
+    s1->scalar = pred >> 63;
+    return ((op & ~instring) | scalar | quote) & ~(quote & ~instring);
+}
+
+static int jictz(uint64_t bits) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int n = 0;
+    while (!(bits & 1)) bits >>= 1, ++n;
+    return n;
+#endif
+}
+
+/* Indexes the chunk that follows the current one */
+static void jiindexchunk(jistage1_t* s1) {
+    const unsigned char* block;
+    s1->begin = s1->limit;
+    s1->limit = s1->end - s1->begin > JC_INDEX_CHUNK
+        ? s1->begin + JC_INDEX_CHUNK : s1->end;
+    s1->count = s1->at = 0;
+
+    for (block = s1->begin; block < s1->limit; block += 64) {
+        unsigned char tail[64];
+        const unsigned char* bytes = block;
+        if (s1->limit - block < 64) {
+            memset(tail, ' ', sizeof tail);
+            memcpy(tail, block, s1->limit - block);
+            bytes = tail;
+        }
+
+        uint64_t bits = jistructurals(s1, bytes);
+        unsigned short offset = block - s1->begin;
+        while (bits) {
+            s1->index[s1->count++] = offset + jictz(bits);
+            bits &= bits - 1;
+        }
+    }
+}
+
+/* Input is scanned through the [cur, end) window, 'fill' slides
+ * it over the next chunk and returns its first character
+ * or negative value when input is over, NULL for flat buffers
+ */
+typedef struct jistate jistate_t;
+struct jistate {
+    const unsigned char *cur, *end;
+    int (*fill)(jistate_t*);
+    void* src; jisb_t sb;
+    unsigned char* buf;
+    jarena_t* arena; // NULL when nodes are allocated by malloc
+    bool insitu; // strings are decoded over the flat input
+    bool lazy; // numbers are converted on access, see JF_LAZY_NUMBERS
+    bool packed; // see JF_PACKED_ARRAYS
+    bool hashed; // see JF_HASHED_OBJECTS
+    bool keep; // 'sb' and 'stk' belong to jcontext_t
+    jisb_t stk; // children of unfinished arrays and objects
+    jistage1_t s1; // structural index of flat input, if any
+};
+
+static void* jialloc(jistate_t* st, size_t size) {
+    return st->arena ? jiarenaalloc(st->arena, size) : JC_MALLOC(size);
+}
+
+static void jidiscard(jistate_t* st, jvalue_t* value) {
+    if (!st->arena) jfree(value);
+}
+
+static int jipeek(jistate_t* st) {
+    if (st->cur < st->end) return *st->cur;
+    return st->fill ? st->fill(st) : -1;
+}
+
+static int jinext(jistate_t* st) {
+    int ch = jipeek(st);
+    if (ch >= 0) ++st->cur;
+    return ch;
+}
+
+static void jiskipws(jistate_t* st) {
+    jistage1_t* s1 = &st->s1;
+    if (s1->index) {
+        if (st->cur >= st->end || !jiisspace(*st->cur)) return;
+        while (st->cur >= s1->limit) {
+            if (s1->limit >= s1->end) { st->cur = st->end; return; }
+            jiindexchunk(s1);
+        }
+
+        /* first byte past spaces is always structural */
+        size_t offset = st->cur - s1->begin;
+        while (true) {
+            while (s1->at < s1->count && s1->index[s1->at] < offset) ++s1->at;
+            if (s1->at < s1->count) {
+                st->cur = s1->begin + s1->index[s1->at];
+                return;
+            }
+            if (s1->limit >= s1->end) { st->cur = st->end; return; }
+            jiindexchunk(s1); offset = 0;
+        }
+    }
+
+    while (true) {
+        while (st->cur < st->end && jiisspace(*st->cur)) ++st->cur;
+        if (st->cur < st->end || !jiisspace(jipeek(st))) break;
+    }
+}
 
 static bool jisbrequire(jisb_t* sb, size_t require) {
     if (sb->len + require > sb->cap) {
-        sb->cap += sb->cap ? sb->cap / 2 : JC_INIT_STR_CAP;
-        void* new = realloc(sb->ptr, sb->cap);
+        size_t cap = sb->cap;
+        do cap += cap ? cap / 2 : JC_INIT_STR_CAP;
+        while (sb->len + require > cap);
+        void* new = JC_REALLOC(sb->ptr, cap);
         if (!new) return false;
         sb->ptr = new;
+        sb->cap = cap;
     }
     return true;
 }
@@ -134,316 +777,1646 @@ static bool jipushchar(int ch, jisb_t* sb) {
     return true;
 }
 
-static bool jipushutf8(unsigned cp, jisb_t* sb) {
+static bool jipushrun(const void* run, size_t size, jisb_t* sb) {
+    if (!jisbrequire(sb, size)) return false;
+    memcpy(sb->ptr + sb->len, run, size);
+    sb->len += size;
+    return true;
+}
+
+static int jiencodeutf8(unsigned cp, char* out) {
     int count_bytes = 0;
     /**/ if (cp < 0x080) count_bytes = 1;
     else if (cp < 0x800) count_bytes = 2;
-    else                 count_bytes = 3;
-
-    if (!jisbrequire(sb, count_bytes)) return false;
+    else if (cp < 0x10000) count_bytes = 3;
+    else                 count_bytes = 4;
 
     switch (count_bytes) {
         case 1:
-            sb->ptr[sb->len++] = cp;
+            out[0] = cp;
             break;
         case 2:
-            sb->ptr[sb->len++] = 0xC0 | cp >> 6;
-            sb->ptr[sb->len++] = 0x80 | (cp & 63);
+            out[0] = 0xC0 | cp >> 6;
+            out[1] = 0x80 | (cp & 63);
             break;
         case 3:
-            sb->ptr[sb->len++] = 0xE0 | cp >> 12;
-            sb->ptr[sb->len++] = 0x80 | ((cp >> 6) & 63);
-            sb->ptr[sb->len++] = 0x80 | (cp & 63);
+            out[0] = 0xE0 | cp >> 12;
+            out[1] = 0x80 | ((cp >> 6) & 63);
+            out[2] = 0x80 | (cp & 63);
             break;
+        case 4:
+            out[0] = 0xF0 | cp >> 18;
+            out[1] = 0x80 | ((cp >> 12) & 63);
+            out[2] = 0x80 | ((cp >> 6) & 63);
+            out[3] = 0x80 | (cp & 63);
+            break;
+    }
+
+    return count_bytes;
+}
+
+static bool jipushutf8(unsigned cp, jisb_t* sb) {
+    if (!jisbrequire(sb, 4)) return false;
+    sb->len += jiencodeutf8(cp, sb->ptr + sb->len);
+    return true;
+}
+
+static bool jiishigh(unsigned cp) { return 0xD800 <= cp && cp <= 0xDBFF; }
+static bool jiislow (unsigned cp) { return 0xDC00 <= cp && cp <= 0xDFFF; }
+
+static unsigned jipaircp(unsigned high, unsigned low) {
+    return 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00);
+}
+
+/* Returns length of well-formed UTF-8 sequence at 'cur' led by
+ * non-ASCII byte or 0 for stray, overlong or surrogate one.
+ * Second byte range depends on the lead, the rest are 80..BF
+ */
+static size_t jiutf8len(const unsigned char* cur, const unsigned char* end) {
+    size_t avail = end - cur;
+    unsigned lead = cur[0];
+    if (lead < 0xE0)
+        return lead >= 0xC2 && avail >= 2 && (cur[1] & 0xC0) == 0x80 ? 2 : 0;
+    if (lead < 0xF0) {
+        if (avail < 3 || (cur[1] & 0xC0) != 0x80 || (cur[2] & 0xC0) != 0x80) return 0;
+        if (lead == 0xE0 && cur[1] < 0xA0) return 0;
+        if (lead == 0xED && cur[1] > 0x9F) return 0;
+        return 3;
+    }
+    if (lead > 0xF4 || avail < 4) return 0;
+    if ((cur[1] & 0xC0) != 0x80 || (cur[2] & 0xC0) != 0x80 || (cur[3] & 0xC0) != 0x80) return 0;
+    if (lead == 0xF0 && cur[1] < 0x90) return 0;
+    if (lead == 0xF4 && cur[1] > 0x8F) return 0;
+    return 4;
+}
+
+/* Skips string bytes that need no care: printable ASCII other
+ * than quote and backslash. Signed compare with space also
+ * catches bytes from 0x80
+ */
+static const char* jiskipplain(const char* cur, const char* end) {
+#if defined(__AVX2__)
+    for (; end - cur >= 32; cur += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(const void*)cur);
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(' '), v));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+        if (mask) return cur + jictz(mask);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; end - cur >= 16; cur += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(const void*)cur);
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+            _mm_cmplt_epi8(v, _mm_set1_epi8(' ')));
+        unsigned mask = (unsigned)_mm_movemask_epi8(m);
+        if (mask) return cur + jictz(mask);
     }
+#endif
+    while (cur < end && *cur != '"' && *cur != '\\'
+        && (unsigned char)*cur >= ' ' && (unsigned char)*cur < 0x80) ++cur;
+    return cur;
+}
 
+static bool jilexhex(jistate_t* st, unsigned* cp) {
+    int digit;
+    *cp = 0;
+    for (size_t i = 0; i < 4; i++)
+        if (jiishex(digit = jinext(st)))
+            *cp = *cp << 4 | jifromhex(digit);
+        else return false;
     return true;
 }
 
-static bool jiparsestring(jreader_t rdr, const char** strptr, bool inentry) {
-    int ch; jisb_t sb = {0};
-    if (rdr.next(rdr.ctx) != '"') goto error;
-    ch = rdr.next(rdr.ctx);
-    while (ch != '"') {
-        if (ch < ' ') goto error;
+/* Multibyte sequence is gathered first as it may cross the window */
+static bool jilexutf8(jistate_t* st, int lead) {
+    unsigned char seq[4] = {(unsigned char)lead};
+    size_t len = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+    for (size_t i = 1; i < len; i++) {
+        int ch = jinext(st);
+        if (ch < 0) return false;
+        seq[i] = (unsigned char)ch;
+    }
+    return jiutf8len(seq, seq + len) == len && jipushrun(seq, len, &st->sb);
+}
+
+/* Decodes string into st->sb, result is not NUL-terminated */
+static bool jilexstring(jistate_t* st, bool inentry) {
+    jisb_t* sb = &st->sb; int ch;
+    sb->len = 0;
+    if (jinext(st) != '"') return false;
+    while (true) {
+        const unsigned char *run = st->cur, *end = st->end;
+        size_t len;
+        while ((run = (const unsigned char*)jiskipplain((const char*)run, (const char*)end)) < end
+            && *run >= 0x80) {
+            while (run < end && *run >= 0x80 && (len = jiutf8len(run, end))) run += len;
+            if (run < end && *run >= 0x80) break; // left to jilexutf8
+        }
+        if (run != st->cur) {
+            if (!jipushrun(st->cur, run - st->cur, sb)) return false;
+            st->cur = run;
+        }
+
+        ch = jinext(st);
+        if (ch == '"') break;
+        if (ch < ' ') return false;
         if (ch == '\\')
-            switch (rdr.next(rdr.ctx)) {
-                case '"' : if (!jipushchar( '"', &sb)) { goto error; } break;
-                case '\\': if (!jipushchar('\\', &sb)) { goto error; } break;
-                case '/' : if (!jipushchar( '/', &sb)) { goto error; } break;
-                case 'b' : if (!jipushchar('\b', &sb)) { goto error; } break;
-                case 'f' : if (!jipushchar('\f', &sb)) { goto error; } break;
-                case 'n' : if (!jipushchar('\n', &sb)) { goto error; } break;
-                case 'r' : if (!jipushchar('\r', &sb)) { goto error; } break;
-                case 't' : if (!jipushchar('\t', &sb)) { goto error; } break;
+            switch (jinext(st)) {
+                case '"' : if (!jipushchar( '"', sb)) { return false; } break;
+                case '\\': if (!jipushchar('\\', sb)) { return false; } break;
+                case '/' : if (!jipushchar( '/', sb)) { return false; } break;
+                case 'b' : if (!jipushchar('\b', sb)) { return false; } break;
+                case 'f' : if (!jipushchar('\f', sb)) { return false; } break;
+                case 'n' : if (!jipushchar('\n', sb)) { return false; } break;
+                case 'r' : if (!jipushchar('\r', sb)) { return false; } break;
+                case 't' : if (!jipushchar('\t', sb)) { return false; } break;
                 case 'u': {
-                    unsigned hex = 0; int digit;
-                    for (size_t i = 0; i < 4; i++)
-                        if (jiishex(digit = rdr.next(rdr.ctx)))
-                            hex = hex << 4 | jifromhex(digit);
-                        else goto error;
-                    if (!jipushutf8(hex, &sb)) goto error;
+                    unsigned cp, low;
+                    if (!jilexhex(st, &cp) || jiislow(cp)) return false;
+                    if (jiishigh(cp)) {
+                        if (jinext(st) != '\\' || jinext(st) != 'u') return false;
+                        if (!jilexhex(st, &low) || !jiislow(low)) return false;
+                        cp = jipaircp(cp, low);
+                    }
+                    if (!jipushutf8(cp, sb)) return false;
                 } break;
-                default: goto error;
+                default: return false;
             }
-        else
-            if (!jipushchar(ch, &sb)) goto error;
-        ch = rdr.next(rdr.ctx);
+        else if (ch >= 0x80) {
+            if (!jilexutf8(st, ch)) return false;
+        } else
+            if (!jipushchar(ch, sb)) return false;
+    }
+
+    ch = jipeek(st);
+    return jiisdelim(ch) || (inentry && ch == ':');
+}
+
+/* Returns end of the number at 'cur' or NULL if it is malformed */
+static const char* jiscannumber(const char* cur, const char* end, bool* integer) {
+    *integer = true;
+    if (cur < end && *cur == '-') ++cur;
+    if (cur >= end) return NULL;
+    if (*cur == '0') ++cur;
+    else if (jiisdec(*cur))
+        while (cur < end && jiisdec(*cur)) ++cur;
+    else return NULL;
+
+    if (cur < end && *cur == '.') {
+        *integer = false;
+        if (++cur >= end || !jiisdec(*cur)) return NULL;
+        while (cur < end && jiisdec(*cur)) ++cur;
     }
 
-    ch = rdr.peek(rdr.ctx);
-    if (!jiisdelim(ch) && (!inentry || ch != ':')) goto error;
-    if (!jipushchar('\0', &sb)) goto error;
+    if (cur < end && (*cur == 'e' || *cur == 'E')) {
+        *integer = false;
+        if (++cur < end && (*cur == '+' || *cur == '-')) ++cur;
+        if (cur >= end || !jiisdec(*cur)) return NULL;
+        while (cur < end && jiisdec(*cur)) ++cur;
+    }
 
-    void* cropped = realloc(sb.ptr, sb.len);
-    if (!cropped) goto error;
-    *strptr = cropped;
+    return cur;
+}
 
+static bool jiscanhex(const char* cur, const char* end, unsigned* cp) {
+    if (end - cur < 4) return false;
+    *cp = 0;
+    for (size_t i = 0; i < 4; i++)
+        if (jiishex(cur[i])) *cp = *cp << 4 | jifromhex(cur[i]);
+        else return false;
     return true;
-error:
-    free(sb.ptr);
-    return false;
 }
 
-static bool jiparsekeyword(jreader_t rdr, const char* kw) {
-    while (*kw) if (rdr.next(rdr.ctx) != *kw++) return false;
-    return jiisdelim(rdr.peek(rdr.ctx));
+/* Returns end of the string body at 'cur' or NULL if it is
+ * malformed: not UTF-8, with bad escape or unpaired surrogate
+ */
+static const char* jiscanstring(const char* cur, const char* end, bool* escaped) {
+    *escaped = false;
+    while ((cur = jiskipplain(cur, end)) < end) {
+        unsigned char ch = *cur;
+        if (ch == '"') return cur;
+        if (ch < ' ') return NULL;
+        if (ch >= 0x80) {
+            do {
+                size_t len = jiutf8len((const unsigned char*)cur, (const unsigned char*)end);
+                if (!len) return NULL;
+                cur += len;
+            } while (cur < end && (unsigned char)*cur >= 0x80);
+            continue;
+        }
+
+        *escaped = true;
+        if (++cur >= end) return NULL;
+        switch (*cur++) {
+            case '"': case '\\': case '/': case 'b':
+            case 'f': case 'n': case 'r': case 't': break;
+            case 'u': {
+                unsigned cp;
+                if (!jiscanhex(cur, end, &cp) || jiislow(cp)) return NULL;
+                cur += 4;
+                if (!jiishigh(cp)) break;
+                if (end - cur < 2 || cur[0] != '\\' || cur[1] != 'u') return NULL;
+                if (!jiscanhex(cur + 2, end, &cp) || !jiislow(cp)) return NULL;
+                cur += 6;
+            } break;
+            default: return NULL;
+        }
+    }
+    return NULL;
 }
 
-static bool jipushvalue(jvalue_t* value, jarray_t* arr, size_t* cap) {
-    if (arr->count >= *cap) {
-        *cap += *cap ? *cap / 2 : JC_INIT_ARR_CAP;
-        void* new = realloc(arr->values, *cap * sizeof *arr->values);
-        if (!new) return false;
-        arr->values = new;
+/* Decodes already validated string body, 'dst' may be 'src' */
+static size_t jiunescape(const char* src, size_t len, char* dst) {
+    const char* end = src + len;
+    char* out = dst;
+    while (src < end) {
+        if (*src != '\\') { *out++ = *src++; continue; }
+
+        switch (*++src) {
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                unsigned hex = 0, low = 0;
+                for (size_t i = 0; i < 4; i++)
+                    hex = hex << 4 | jifromhex(*++src);
+                if (jiishigh(hex)) {
+                    src += 2;
+                    for (size_t i = 0; i < 4; i++)
+                        low = low << 4 | jifromhex(*++src);
+                    hex = jipaircp(hex, low);
+                }
+                out += jiencodeutf8(hex, out);
+            } break;
+            default: *out++ = *src; break;
+        }
+        ++src;
+    }
+    *out = '\0';
+    return out - dst;
+}
+
+/* String storage is preceded by 'room' bytes of the same allocation */
+static bool jiparsestring(jistate_t* st, const char** strptr, bool inentry, size_t room) {
+    bool intern = inentry && st->arena && !st->insitu;
+    if (st->fill) {
+        if (!jilexstring(st, inentry)) return false;
+        if (intern) return (*strptr = jiintern(st->arena, st->sb.ptr, st->sb.len)) != NULL;
+        char* str = jialloc(st, room + st->sb.len + 1);
+        if (!str) return false;
+        str += room;
+        if (st->sb.len) memcpy(str, st->sb.ptr, st->sb.len);
+        str[st->sb.len] = '\0';
+        *strptr = str;
+        return true;
+    }
+
+    /* Flat input holds the whole string, so it is decoded
+     * straight into its storage or, in place, over itself
+     */
+    const char *begin, *end; bool escaped; int ch;
+    if (st->cur >= st->end || *st->cur != '"') return false;
+    begin = (const char*)st->cur + 1;
+    end = jiscanstring(begin, (const char*)st->end, &escaped);
+    if (!end) return false;
+    st->cur = (const unsigned char*)end + 1;
+    ch = jipeek(st);
+    if (!jiisdelim(ch) && (!inentry || ch != ':')) return false;
+
+    /* index must not see the bytes that are overwritten in place */
+    while (st->insitu && st->s1.index && st->s1.limit <= (const unsigned char*)end)
+        jiindexchunk(&st->s1);
+
+    if (intern) {
+        size_t len = end - begin;
+        if (escaped) {
+            st->sb.len = 0;
+            if (!jisbrequire(&st->sb, len)) return false;
+            len = jiunescape(begin, len, st->sb.ptr);
+            begin = st->sb.ptr;
+        }
+        return (*strptr = jiintern(st->arena, begin, len)) != NULL;
+    }
+
+    char* str = st->insitu ? (char*)begin : jialloc(st, room + (end - begin) + 1);
+    if (!str) return false;
+    if (!st->insitu) str += room;
+    if (escaped)
+        (void)jiunescape(begin, end - begin, str);
+    else {
+        if (!st->insitu) memcpy(str, begin, end - begin);
+        str[end - begin] = '\0';
     }
+    *strptr = str;
 
-    arr->values[arr->count++] = value;
     return true;
 }
 
-static bool jipushentry(jentry_t entry, jobject_t* obj, size_t* cap) {
-    if (obj->count >= *cap) {
-        *cap += *cap ? *cap / 2 : JC_INIT_OBJ_CAP;
-        void* new = realloc(obj->entries, *cap * sizeof *obj->entries);
-        if (!new) return false;
-        obj->entries = new;
+static bool jiparsekeyword(jistate_t* st, const char* kw) {
+    while (*kw) if (jinext(st) != *kw++) return false;
+    return jiisdelim(jipeek(st));
+}
+
+/* Moves children pushed since 'base' into their final storage,
+ * leaving 'extra' bytes after them
+ */
+static void* jipopchildren(jistate_t* st, size_t base, size_t extra) {
+    size_t size = st->stk.len - base;
+    void* children = jialloc(st, size + extra);
+    if (!children) return NULL;
+    memcpy(children, st->stk.ptr + base, size);
+    st->stk.len = base;
+    return children;
+}
+
+static void jidropchildren(jistate_t* st, size_t base, jtype_t type) {
+    if (!st->arena) {
+        char* item = st->stk.ptr + base;
+        char* last = st->stk.ptr + st->stk.len;
+        if (type == JT_ARRAY)
+            for (; item < last; item += sizeof(jvalue_t*))
+                jfree(*(jvalue_t**)(void*)item);
+        else
+            for (; item < last; item += sizeof(jentry_t)) {
+                jentry_t* entry = (jentry_t*)(void*)item;
+                JC_FREE((void*)entry->key);
+                jfree(entry->value);
+            }
+    }
+    st->stk.len = base;
+}
+
+#define JI_ROOMY  1u // entries are followed by room for hash index
+#define JI_HASHED 2u // hash index is built
+#define JI_INLINE 4u // string or number text is stored right after the node
+#define JI_LAZY   8u // number is not converted from its text yet
+#define JI_PACKED_INTEGERS 16u // array holds long long values, not nodes
+#define JI_PACKED_NUMBERS  32u // array holds double values, not nodes
+
+/* First word of node with the bits jvalue_t leaves unnamed, it is
+ * copied by memcpy, so node is never read through another type
+ */
+typedef struct jihead {
+    unsigned type  : 8;
+    unsigned flags : 24;
+} jihead_t;
+
+static unsigned jiflags(const jvalue_t* value) {
+    jihead_t head;
+    memcpy(&head, value, sizeof head);
+    return head.flags;
+}
+
+static void jisetflags(jvalue_t* value, unsigned flags) {
+    jihead_t head;
+    memcpy(&head, value, sizeof head);
+    head.flags = flags;
+    memcpy(value, &head, sizeof head);
+}
+
+/* Hash index lies after entries: hash of each key, then open
+ * addressing slots holding entry number + 1
+ */
+static size_t jislots(size_t count) {
+    size_t cap = 1;
+    while (cap < count + count / 2) cap <<= 1;
+    return cap;
+}
+
+static size_t jiindexsize(size_t count) {
+    return (count + jislots(count)) * sizeof(unsigned);
+}
+
+/* Moves entries pushed since 'base' into object 'value' */
+static bool jipopentries(jistate_t* st, jvalue_t* value, size_t base) {
+    size_t count = (st->stk.len - base) / sizeof(jentry_t), extra = 0;
+    if (st->hashed && count >= JC_HASH_MIN && count < UINT_MAX) {
+        extra = jiindexsize(count);
+        jisetflags(value, jiflags(value) | JI_ROOMY);
     }
+    value->as.object.count = count;
+    value->as.object.entries = jipopchildren(st, base, extra);
+    if (!value->as.object.entries) value->as.object.count = 0;
+    return value->as.object.entries != NULL;
+}
+
+
+static const double jipow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Converts number text already checked by jiscannumber. Digits
+ * are accumulated into the mantissa, which with up to 2^53 and
+ * power of ten up to 22 gives exact double in one operation,
+ * only the rest of numbers goes through strtod
+ */
+static bool jiconvnumber(const char* text, size_t size, bool integer, jvalue_t* value) {
+    const char* end = text + size;
+    const char* cur = text;
+    unsigned long long mant = 0;
+    int digits = 0, exp = 0;
+    bool neg = *cur == '-', truncated = false;
+
+    cur += neg;
+    for (; cur < end && jiisdec(*cur); ++cur)
+        if (digits < 19) mant = mant * 10 + (*cur - '0'), digits += mant != 0;
+        else truncated = true;
+
+    value->type = integer ? JT_INTEGER : JT_NUMBER;
+    if (integer) {
+        if (truncated || mant > (unsigned long long)LLONG_MAX + neg) return false;
+        value->as.integer = !neg ? (long long)mant
+            : mant ? -(long long)(mant - 1) - 1 : 0;
+        return true;
+    }
+
+    if (cur < end && *cur == '.') {
+        for (++cur; cur < end && jiisdec(*cur); ++cur)
+            if (digits < 19) {
+                mant = mant * 10 + (*cur - '0');
+                digits += mant != 0; --exp;
+            } else truncated = true;
+    }
+
+    if (cur < end) {
+        int power = 0;
+        bool negpower = *++cur == '-';
+        cur += *cur == '-' || *cur == '+';
+        for (; cur < end; ++cur)
+            if (power < 100000) power = power * 10 + (*cur - '0');
+        exp += negpower ? -power : power;
+    }
+
+#if FLT_EVAL_METHOD == 0
+    if (!truncated && mant <= 1ull << 53) {
+        double number = (double)mant;
+        if (exp > 22 && exp <= 22 + 15) {
+            number *= jipow10[exp - 22];
+            exp = number <= (double)(1ull << 53) ? 22 : INT_MAX;
+        }
+        if (-22 <= exp && exp <= 22) {
+            number = exp < 0 ? number / jipow10[-exp] : number * jipow10[exp];
+            value->as.number = neg ? -number : number;
+            return true;
+        }
+    }
+#endif
+
+    char buffer[JC_NUM_BUF_SIZE], *stop;
+    if (size >= sizeof buffer) return false;
+    memcpy(buffer, text, size);
+    buffer[size] = '\0'; errno = 0;
+    value->as.number = strtod(buffer, &stop);
+    return errno != ERANGE && buffer + size == stop;
+}
+
+/* Tells if jiconvnumber takes the number without converting it,
+ * strtod is left only for fractions near the limits of double
+ */
+static bool jinumberfits(const char* text, size_t size, bool integer) {
+    const char* end = text + size;
+    const char* cur = text;
+    int mag = 0, power = 0;
+    bool nonzero = false, negpower;
+    jvalue_t num;
+    if (integer || size >= JC_NUM_BUF_SIZE) return jiconvnumber(text, size, integer, &num);
+
+    cur += *cur == '-';
+    for (; cur < end && jiisdec(*cur); ++cur)
+        if (nonzero || *cur != '0') { nonzero = true; ++mag; }
+    if (cur < end && *cur == '.') {
+        for (++cur; cur < end && jiisdec(*cur) && !nonzero; ++cur) {
+            if (*cur == '0') --mag;
+            else nonzero = true;
+        }
+    }
+    if (!nonzero) return true;
+
+    while (cur < end && jiisdec(*cur)) ++cur;
+    if (cur < end) {
+        negpower = *++cur == '-';
+        cur += *cur == '-' || *cur == '+';
+        for (; cur < end; ++cur)
+            if (power < 100000) power = power * 10 + (*cur - '0');
+        if (negpower) power = -power;
+    }
+    if (-300 <= mag + power && mag + power <= 300) return true;
+    return jiconvnumber(text, size, integer, &num);
+}
+
+static bool jiisnumchar(int ch) {
+    return jiisdec(ch) || ch == '-' || ch == '+'
+        || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+/* Takes checked text of the number at input, it points into
+ * flat input or is copied into 'buffer' of JC_NUM_BUF_SIZE
+ */
+static bool jilexnumber(jistate_t* st, char* buffer, const char** text, size_t* size, bool* integer) {
+    *text = buffer; *size = 0;
+    if (st->fill) {
+        while (jiisnumchar(jipeek(st))) {
+            if (*size >= JC_NUM_BUF_SIZE) return false;
+            buffer[(*size)++] = jinext(st);
+        }
+    } else {
+        *text = (const char*)st->cur;
+        while (st->cur < st->end && jiisnumchar(*st->cur)) ++st->cur;
+        *size = (const char*)st->cur - *text;
+    }
+    return jiscannumber(*text, *text + *size, integer) == *text + *size
+        && jiisdelim(jipeek(st));
+}
+
+/* Sets type and value of the number at input into 'value' */
+static bool jiparsenumber(jistate_t* st, jvalue_t* value) {
+    char buffer[JC_NUM_BUF_SIZE];
+    const char* text; size_t size; bool integer;
+    if (!jilexnumber(st, buffer, &text, &size, &integer)) return false;
+    return jiconvnumber(text, size, integer, value);
+}
+
+/* Lazy number keeps its text right after the node until the
+ * first jinteger or jnumber, integers that may overflow and
+ * too long texts are converted at once to fail as usual
+ */
+static jvalue_t* jiparselazy(jistate_t* st) {
+    char buffer[JC_NUM_BUF_SIZE];
+    const char* text; size_t size; bool integer;
+    jvalue_t* value;
+    if (!jilexnumber(st, buffer, &text, &size, &integer)) return NULL;
+
+    value = jialloc(st, sizeof *value + size + 1);
+    if (!value) return NULL;
+    memset(value, 0, sizeof *value);
+    memcpy(value + 1, text, size);
+    ((char*)(value + 1))[size] = '\0';
+    value->type = integer ? JT_INTEGER : JT_NUMBER;
+    jisetflags(value, JI_INLINE | JI_LAZY);
+
+    if (size >= JC_NUM_BUF_SIZE || (integer && size - (*text == '-') > 18)) {
+        jisetflags(value, JI_INLINE);
+        if (!jiconvnumber(text, size, integer, value)) {
+            jidiscard(st, value); return NULL;
+        }
+    }
+    jiskipws(st);
+    return value;
+}
 
-    obj->entries[obj->count++] = entry;
+/* Turns raw values pushed since 'base' into nodes in place,
+ * a pointer is never wider than a value
+ */
+static bool jiunpack(jistate_t* st, size_t base, jtype_t type) {
+    size_t count = (st->stk.len - base) / sizeof(long long);
+    for (size_t i = 0; i < count; i++) {
+        jvalue_t* node = jialloc(st, sizeof *node);
+        if (!node) { st->stk.len = base + i * sizeof node; return false; }
+        memset(node, 0, sizeof *node);
+        node->type = type;
+        memcpy(&node->as, st->stk.ptr + base + i * sizeof(long long), sizeof(long long));
+        memcpy(st->stk.ptr + base + i * sizeof node, &node, sizeof node);
+    }
+    st->stk.len = base + count * sizeof(jvalue_t*);
     return true;
 }
 
-static int jientrycmp(const void* lhs, const void* rhs) {
-    const jentry_t *l = lhs, *r = rhs;
-    return strcmp(l->key, r->key);
+/* Pushes leading numbers of non-empty array as raw values while
+ * they are of one type and packs them if array ends there, sets
+ * 'chptr' to ']'. Otherwise they become nodes and array goes on
+ * from 'chptr' as usual
+ */
+static bool jiparsepacked(jistate_t* st, jvalue_t* value, size_t base, int* chptr) {
+    jtype_t type = JT_NULL;
+    jvalue_t num = {0}; int ch;
+    while (true) {
+        jiskipws(st);
+        ch = jipeek(st);
+        if (ch != '-' && !jiisdec(ch)) { ch = ','; break; }
+        if (!jiparsenumber(st, &num)) goto error;
+        jiskipws(st);
+        if (type == JT_NULL) type = num.type;
+        if (num.type != type) {
+            if (!jiunpack(st, base, type)) return false;
+            jvalue_t* node = jialloc(st, sizeof *node);
+            if (!node) return false;
+            *node = num;
+            jisetflags(node, 0);
+            if (!jipushrun(&node, sizeof node, &st->stk)) {
+                jidiscard(st, node); return false;
+            }
+            *chptr = jinext(st);
+            return *chptr == ',' || *chptr == ']';
+        }
+        if (!jipushrun(&num.as, sizeof(long long), &st->stk)) goto error;
+
+        ch = jinext(st);
+        if (ch == ']') {
+            value->as.array.count = (st->stk.len - base) / sizeof(long long);
+            value->as.array.values = jipopchildren(st, base, 0);
+            if (!value->as.array.values) goto error;
+            jisetflags(value, jiflags(value)
+                | (type == JT_INTEGER ? JI_PACKED_INTEGERS : JI_PACKED_NUMBERS));
+            *chptr = ch;
+            return true;
+        }
+        if (ch != ',') goto error;
+    }
+    *chptr = ch;
+    return jiunpack(st, base, type);
+error:
+    value->as.array.count = 0;
+    st->stk.len = base;
+    return false;
 }
 
-static jvalue_t* jiparsevalue(jreader_t rdr) {
-    jvalue_t* value = malloc(sizeof *value);
+static jvalue_t* jiparsevalue(jistate_t* st) {
+    jvalue_t* value;
+    jiskipws(st);
+
+    /* string comes first to be allocated along with its node */
+    if (jipeek(st) == '"' && !st->insitu) {
+        const char* str;
+        if (!jiparsestring(st, &str, false, sizeof *value)) return NULL;
+        value = (jvalue_t*)(void*)(str - sizeof *value);
+        memset(value, 0, sizeof *value);
+        value->type = JT_STRING;
+        jisetflags(value, JI_INLINE);
+        value->as.string = str;
+        jiskipws(st);
+        return value;
+    }
+    if (st->lazy && (jipeek(st) == '-' || jiisdec(jipeek(st))))
+        return jiparselazy(st);
+
+    value = jialloc(st, sizeof *value);
     if (!value) return NULL;
     memset(value, 0, sizeof *value);
 
-    jiskipws(rdr);
-    switch (rdr.peek(rdr.ctx)) {
+    switch (jipeek(st)) {
         case 'n': {
             value->type = JT_NULL;
-            if (!jiparsekeyword(rdr, "null")) goto error;
+            if (!jiparsekeyword(st, "null")) goto error;
         } break;
         case 'f': {
             value->type = JT_BOOLEAN;
-            if (!jiparsekeyword(rdr, "false")) goto error;
+            if (!jiparsekeyword(st, "false")) goto error;
             value->as.boolean = false;
         } break;
         case 't': {
             value->type = JT_BOOLEAN;
-            if (!jiparsekeyword(rdr, "true")) goto error;
+            if (!jiparsekeyword(st, "true")) goto error;
             value->as.boolean = true;
         } break;
         case '"': {
             value->type = JT_STRING;
-            if (!jiparsestring(rdr, &value->as.string, false)) goto error;
+            if (!jiparsestring(st, &value->as.string, false, 0)) goto error;
         } break;
         case '[': {
             value->type = JT_ARRAY;
-            (void)rdr.next(rdr.ctx);
-            jiskipws(rdr);
-            if (rdr.peek(rdr.ctx) == ']') {
-                (void)rdr.next(rdr.ctx); break;
+            (void)jinext(st);
+            jiskipws(st);
+            if (jipeek(st) == ']') {
+                (void)jinext(st); break;
             }
 
-            size_t cap = 0; int ch;
-            do {
-                jvalue_t* element = jiparsevalue(rdr);
-                if (!element) goto error;
-                if(!jipushvalue(element, &value->as.array, &cap)) goto error;
-                ch = rdr.next(rdr.ctx);
-                if (ch != ',' && ch != ']') goto error;
-            } while (ch == ',');
+            size_t base = st->stk.len; int ch = ',';
+            if (st->packed && !jiparsepacked(st, value, base, &ch)) goto error_arr;
+            while (ch == ',') {
+                jvalue_t* element = jiparsevalue(st);
+                if (!element) goto error_arr;
+                if (!jipushrun(&element, sizeof element, &st->stk)) {
+                    jidiscard(st, element); goto error_arr;
+                }
+                ch = jinext(st);
+                if (ch != ',' && ch != ']') goto error_arr;
+            }
+            if (jiflags(value) & (JI_PACKED_INTEGERS | JI_PACKED_NUMBERS)) break;
+
+            value->as.array.count = (st->stk.len - base) / sizeof(jvalue_t*);
+            value->as.array.values = jipopchildren(st, base, 0);
+            if (!value->as.array.values) goto error_arr;
 
-            void* cropped = realloc(value->as.array.values,
-                sizeof *value->as.array.values * value->as.array.count);
-            if (!cropped) goto error;
-            value->as.array.values = cropped;
+            break;
+        error_arr:
+            value->as.array.count = 0;
+            jidropchildren(st, base, JT_ARRAY);
+            goto error;
         } break;
         case '{': {
             value->type = JT_OBJECT;
-            (void)rdr.next(rdr.ctx);
-            jiskipws(rdr);
-            if (rdr.peek(rdr.ctx) == '}') {
-                (void)rdr.next(rdr.ctx); break;
+            (void)jinext(st);
+            jiskipws(st);
+            if (jipeek(st) == '}') {
+                (void)jinext(st); break;
             }
 
             jentry_t entry;
-            size_t cap = 0; int ch;
+            size_t base = st->stk.len; int ch;
             do {
                 memset(&entry, 0, sizeof entry);
 
-                jiskipws(rdr);
-                if (!jiparsestring(rdr, &entry.key, true)) goto error_obj;
-                jiskipws(rdr);
-                if (rdr.next(rdr.ctx) != ':') goto error_obj;
-                entry.value = jiparsevalue(rdr);
+                jiskipws(st);
+                if (!jiparsestring(st, &entry.key, true, 0)) goto error_obj;
+                jiskipws(st);
+                if (jinext(st) != ':') goto error_obj;
+                entry.value = jiparsevalue(st);
                 if (!entry.value) goto error_obj;
-                if (!jipushentry(entry, &value->as.object, &cap)) goto error_obj;
+                if (!jipushrun(&entry, sizeof entry, &st->stk)) goto error_obj;
 
-                ch = rdr.next(rdr.ctx);
-                if (ch != ',' && ch != '}') goto error;
+                ch = jinext(st);
+                if (ch != ',' && ch != '}') goto error_objs;
             } while (ch == ',');
 
-            void* cropped = realloc(value->as.object.entries,
-                sizeof *value->as.object.entries * value->as.object.count);
-            if (!cropped) goto error;
-            value->as.object.entries = cropped;
-            qsort(value->as.object.entries, value->as.object.count,
-                sizeof *value->as.object.entries, jientrycmp);
+            if (!jipopentries(st, value, base)) goto error_objs;
 
             break;
         error_obj:
-            free((void*)entry.key);
-            jfree(entry.value);
+            if (!st->arena) JC_FREE((void*)entry.key);
+            jidiscard(st, entry.value);
+        error_objs:
+            value->as.object.count = 0;
+            jidropchildren(st, base, JT_OBJECT);
             goto error;
         } break;
         default: {
-            static char buffer[JC_NUM_BUF_SIZE];
-            size_t size = 0; int ch;
-            memset(buffer, 0, sizeof buffer);
+            if (!jiparsenumber(st, value)) goto error;
+        } break;
+    }
+    jiskipws(st);
 
-            value->type = JT_INTEGER;
-            if (rdr.peek(rdr.ctx) == '-') {
-                if (size >= sizeof buffer - 1) goto error;
-                buffer[size++] = rdr.next(rdr.ctx);
-            }
+    return value;
+error:
+    jidiscard(st, value);
+    return NULL;
+}
 
-            ch = rdr.next(rdr.ctx);
-            /*  */ if (ch == '0') {
-                if (size >= sizeof buffer - 1) goto error;
-                buffer[size++] = '0';
-            } else if (jiisdec(ch)) {
-                if (size >= sizeof buffer - 1) goto error;
-                buffer[size++] = ch;
-                while (jiisdec(rdr.peek(rdr.ctx))) {
-                    if (size >= sizeof buffer - 1) goto error;
-                    buffer[size++] = rdr.next(rdr.ctx);
-                }
-            } else goto error;
-
-            if (rdr.peek(rdr.ctx) == '.') {
-                value->type = JT_NUMBER;
-                if (size >= sizeof buffer - 1) goto error;
-                buffer[size++] = rdr.next(rdr.ctx);
-                if (!jiisdec(rdr.peek(rdr.ctx))) goto error;
-                while (jiisdec(rdr.peek(rdr.ctx))) {
-                    if (size >= sizeof buffer - 1) goto error;
-                    buffer[size++] = rdr.next(rdr.ctx);
-                }
+static jvalue_t* jiparse(jistate_t* st) {
+    jvalue_t* json = jiparsevalue(st);
+    if (!st->keep) {
+        JC_FREE(st->sb.ptr);
+        JC_FREE(st->stk.ptr);
+    }
+    if (!json) return json;
+    if (jinext(st) < 0)
+        return json;
+    jidiscard(st, json);
+    return NULL;
+}
+
+static int jifillreader(jistate_t* st) {
+    jreader_t* rdr = st->src;
+    size_t size = 0; int ch;
+    while (size < JC_RDR_BUF_SIZE && (ch = rdr->next(rdr->ctx)) >= 0)
+        st->buf[size++] = ch;
+    st->cur = st->buf;
+    st->end = st->buf + size;
+    return size ? *st->cur : -1;
+}
+
+jvalue_t* jparse(jreader_t rdr) {
+    unsigned char buf[JC_RDR_BUF_SIZE];
+    jistate_t st = {0};
+    st.fill = jifillreader;
+    st.buf = buf;
+    st.src = &rdr;
+    return jiparse(&st);
+}
+
+jvalue_t* jparse_cstr(const char* str) {
+    if (!str) return NULL;
+    return jparse_buffer(str, strlen(str));
+}
+
+/* Flat input large enough to span chunks is walked by index */
+static void jiflat(jistate_t* st, const char* buf, size_t len, unsigned short* index) {
+    st->cur = (const unsigned char*)buf;
+    st->end = (const unsigned char*)buf + len;
+    if (len >= JC_INDEX_CHUNK) {
+        st->s1.index = index;
+        st->s1.begin = st->s1.limit = st->cur;
+        st->s1.end = st->end;
+        st->s1.scalar = 1;
+    }
+}
+
+jvalue_t* jparse_buffer(const char* buf, size_t len) {
+    unsigned short index[JC_INDEX_CHUNK];
+    jistate_t st = {0};
+    if (!buf) return NULL;
+    jiflat(&st, buf, len, index);
+    return jiparse(&st);
+}
+
+static jvalue_t* jiparsearena(jistate_t* st, jarena_t* arena, const char* buf, size_t len) {
+    unsigned short index[JC_INDEX_CHUNK];
+    if (!arena || !buf) return NULL;
+    jiflat(st, buf, len, index);
+    st->arena = arena;
+
+    jiblock_t* top = arena->top;
+    char* begin = top ? top->begin : NULL;
+    size_t keycount = arena->keycount;
+    jvalue_t* json = jiparse(st);
+    if (!json) {
+        jiarenarewind(arena, top, begin);
+        if (arena->keycount != keycount) jiforgetkeys(arena);
+    }
+    return json;
+}
+
+jvalue_t* jparse_arena(jarena_t* arena, const char* buf, size_t len) {
+    jistate_t st = {0};
+    return jiparsearena(&st, arena, buf, len);
+}
+
+jvalue_t* jparse_insitu(jarena_t* arena, char* buf, size_t len) {
+    jistate_t st = {0};
+    st.insitu = true;
+    return jiparsearena(&st, arena, buf, len);
+}
+
+static jvalue_t* jiparseflags(jistate_t* st, jarena_t* arena, const char* buf, size_t len, unsigned flags) {
+    unsigned short index[JC_INDEX_CHUNK];
+    st->lazy = flags & JF_LAZY_NUMBERS;
+    st->packed = flags & JF_PACKED_ARRAYS;
+    st->hashed = flags & JF_HASHED_OBJECTS;
+    if (arena) return jiparsearena(st, arena, buf, len);
+    if (!buf) return NULL;
+    jiflat(st, buf, len, index);
+    return jiparse(st);
+}
+
+jvalue_t* jparse_flags(jarena_t* arena, const char* buf, size_t len, unsigned flags) {
+    jistate_t st = {0};
+    return jiparseflags(&st, arena, buf, len, flags);
+}
+
+struct jcontext {
+    jisb_t sb, stk;
+};
+
+jcontext_t* jcontext_init(void) {
+    jcontext_t* ctx = JC_MALLOC(sizeof *ctx);
+    if (ctx) memset(ctx, 0, sizeof *ctx);
+    return ctx;
+}
+
+void jcontext_free(jcontext_t* ctx) {
+    if (!ctx) return;
+    JC_FREE(ctx->sb.ptr);
+    JC_FREE(ctx->stk.ptr);
+    JC_FREE(ctx);
+}
+
+jvalue_t* jparse_context(jcontext_t* ctx, jarena_t* arena, const char* buf, size_t len, unsigned flags) {
+    jistate_t st = {0};
+    if (!ctx) return NULL;
+    st.sb = ctx->sb; st.sb.len = 0;
+    st.stk = ctx->stk; st.stk.len = 0;
+    st.keep = true;
+    jvalue_t* json = jiparseflags(&st, arena, buf, len, flags);
+    ctx->sb = st.sb;
+    ctx->stk = st.stk;
+    return json;
+}
+
+jtype_t jpacked(const jvalue_t* arr) {
+    if (!arr || arr->type != JT_ARRAY) return JT_NULL;
+    if (jiflags(arr) & JI_PACKED_INTEGERS) return JT_INTEGER;
+    if (jiflags(arr) & JI_PACKED_NUMBERS) return JT_NUMBER;
+    return JT_NULL;
+}
+
+const long long* jintegers(const jvalue_t* arr) {
+    if (jpacked(arr) != JT_INTEGER) return NULL;
+    return (const long long*)(const void*)arr->as.array.values;
+}
+
+const double* jnumbers(const jvalue_t* arr) {
+    if (jpacked(arr) != JT_NUMBER) return NULL;
+    return (const double*)(const void*)arr->as.array.values;
+}
+
+static void jiconvlazy(jvalue_t* value) {
+    const char* text = (const char*)(value + 1);
+    (void)jiconvnumber(text, strlen(text), value->type == JT_INTEGER, value);
+    jisetflags(value, jiflags(value) & ~JI_LAZY);
+}
+
+long long jinteger(jvalue_t* value) {
+    if (!value) return 0;
+    if (jiflags(value) & JI_LAZY) jiconvlazy(value);
+    if (value->type == JT_INTEGER) return value->as.integer;
+    if (value->type == JT_NUMBER) return (long long)value->as.number;
+    return 0;
+}
+
+double jnumber(jvalue_t* value) {
+    if (!value) return 0;
+    if (jiflags(value) & JI_LAZY) jiconvlazy(value);
+    if (value->type == JT_NUMBER) return value->as.number;
+    if (value->type == JT_INTEGER) return (double)value->as.integer;
+    return 0;
+}
+
+#ifdef JI_MMAP
+static int jifilldesc(jistate_t* st) {
+    ssize_t size;
+    do size = read((int)(intptr_t)st->src, st->buf, JC_RDR_BUF_SIZE);
+    while (size < 0 && errno == EINTR);
+    st->cur = st->buf;
+    st->end = st->buf + (size > 0 ? size : 0);
+    return size > 0 ? *st->cur : -1;
+}
+#else
+static int jifillfile(jistate_t* st) {
+    size_t size = fread(st->buf, 1, JC_RDR_BUF_SIZE, st->src);
+    st->cur = st->buf;
+    st->end = st->buf + size;
+    return size ? *st->cur : -1;
+}
+#endif
+
+/* Opens file once: regular non-empty one is mapped and returned
+ * to read as flat input, others are set in 'st' to read by chunks
+ * into 'buf' and closed by jiclosefile. Failure leaves no 'fill'
+ */
+static const char* jiopenfile(jistate_t* st, const char* filename, size_t* len, unsigned char* buf) {
+#ifdef JI_MMAP
+    struct stat info; void* map;
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)
+        && info.st_size > 0 && (uintmax_t)info.st_size <= SIZE_MAX) {
+        *len = (size_t)info.st_size;
+        map = mmap(NULL, *len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            close(fd);
+#ifdef POSIX_MADV_SEQUENTIAL
+            (void)posix_madvise(map, *len, POSIX_MADV_SEQUENTIAL);
+#endif
+            return map;
+        }
+    }
+    st->src = (void*)(intptr_t)fd;
+    st->fill = jifilldesc;
+#else
+    (void)len;
+    if (!(st->src = fopen(filename, "r"))) return NULL;
+    st->fill = jifillfile;
+#endif
+    st->buf = buf;
+    return NULL;
+}
+
+static void jiclosefile(jistate_t* st) {
+#ifdef JI_MMAP
+    close((int)(intptr_t)st->src);
+#else
+    fclose(st->src);
+#endif
+}
+
+static void jiunmapfile(const char* map, size_t len) {
+#ifdef JI_MMAP
+    munmap((void*)map, len);
+#else
+    (void)map; (void)len;
+#endif
+}
+
+jvalue_t* jparse_file(const char* filename) {
+    unsigned char buf[JC_RDR_BUF_SIZE];
+    jistate_t st = {0};
+    if (!filename) return NULL;
+
+    size_t len; const char* map = jiopenfile(&st, filename, &len, buf);
+    if (map) {
+        unsigned short index[JC_INDEX_CHUNK];
+        jiflat(&st, map, len, index);
+        jvalue_t* json = jiparse(&st);
+        jiunmapfile(map, len);
+        return json;
+    }
+
+    if (!st.fill) return NULL;
+    jvalue_t* json = jiparse(&st);
+    jiclosefile(&st);
+    return json;
+}
+
+/* Nesting is kept as a bit per level: set for objects */
+static bool jisax(jistate_t* st, const jhandler_t* h) {
+    unsigned char nest[JC_MAX_DEPTH / 8];
+    size_t depth = 0; int ch;
+    jvalue_t num;
+
+value:
+    jiskipws(st);
+    switch (jipeek(st)) {
+        case 'n':
+            if (!jiparsekeyword(st, "null")) goto error;
+            if (h->null && !h->null(h->ctx)) goto error;
+            break;
+        case 'f':
+            if (!jiparsekeyword(st, "false")) goto error;
+            if (h->boolean && !h->boolean(h->ctx, false)) goto error;
+            break;
+        case 't':
+            if (!jiparsekeyword(st, "true")) goto error;
+            if (h->boolean && !h->boolean(h->ctx, true)) goto error;
+            break;
+        case '"':
+            if (!jilexstring(st, false) || !jipushchar('\0', &st->sb)) goto error;
+            if (h->string && !h->string(h->ctx, st->sb.ptr, st->sb.len - 1)) goto error;
+            break;
+        case '[':
+            (void)jinext(st);
+            if (h->array_begin && !h->array_begin(h->ctx)) goto error;
+            jiskipws(st);
+            if (jipeek(st) == ']') {
+                (void)jinext(st);
+                if (h->array_end && !h->array_end(h->ctx)) goto error;
+                break;
             }
+            if (depth >= JC_MAX_DEPTH) goto error;
+            nest[depth / 8] &= ~(1u << depth % 8); ++depth;
+            goto value;
+        case '{':
+            (void)jinext(st);
+            if (h->object_begin && !h->object_begin(h->ctx)) goto error;
+            jiskipws(st);
+            if (jipeek(st) == '}') {
+                (void)jinext(st);
+                if (h->object_end && !h->object_end(h->ctx)) goto error;
+                break;
+            }
+            if (depth >= JC_MAX_DEPTH) goto error;
+            nest[depth / 8] |= 1u << depth % 8; ++depth;
+            goto key;
+        default:
+            if (!jiparsenumber(st, &num)) goto error;
+            if (num.type == JT_INTEGER) {
+                if (h->integer && !h->integer(h->ctx, num.as.integer)) goto error;
+            } else {
+                if (h->number && !h->number(h->ctx, num.as.number)) goto error;
+            }
+            break;
+    }
 
-            ch = rdr.peek(rdr.ctx);
-            if (ch == 'e' || ch == 'E') {
-                value->type = JT_NUMBER;
-                if (size >= sizeof buffer - 1) goto error;
-                buffer[size++] = rdr.next(rdr.ctx);
-                ch = rdr.peek(rdr.ctx);
-                if (ch == '+' || ch == '-') {
-                    if (size >= sizeof buffer - 1) goto error;
-                    buffer[size++] = rdr.next(rdr.ctx);
-                }
-                while (jiisdec(rdr.peek(rdr.ctx))) {
-                    if (size >= sizeof buffer - 1) goto error;
-                    buffer[size++] = rdr.next(rdr.ctx);
-                }
+next:
+    jiskipws(st);
+    if (depth == 0) goto done;
+    ch = jinext(st);
+    if (nest[(depth - 1) / 8] & 1u << (depth - 1) % 8) {
+        if (ch == ',') goto key;
+        if (ch != '}') goto error;
+        if (h->object_end && !h->object_end(h->ctx)) goto error;
+    } else {
+        if (ch == ',') goto value;
+        if (ch != ']') goto error;
+        if (h->array_end && !h->array_end(h->ctx)) goto error;
+    }
+    --depth;
+    goto next;
+
+key:
+    jiskipws(st);
+    if (!jilexstring(st, true) || !jipushchar('\0', &st->sb)) goto error;
+    if (h->key && !h->key(h->ctx, st->sb.ptr, st->sb.len - 1)) goto error;
+    jiskipws(st);
+    if (jinext(st) != ':') goto error;
+    goto value;
+
+done:
+    JC_FREE(st->sb.ptr);
+    return jinext(st) < 0;
+error:
+    JC_FREE(st->sb.ptr);
+    return false;
+}
+
+bool jsax(jreader_t rdr, const jhandler_t* handler) {
+    unsigned char buf[JC_RDR_BUF_SIZE];
+    jistate_t st = {0};
+    if (!handler) return false;
+    st.fill = jifillreader;
+    st.buf = buf;
+    st.src = &rdr;
+    return jisax(&st, handler);
+}
+
+bool jsax_buffer(const char* buf, size_t len, const jhandler_t* handler) {
+    unsigned short index[JC_INDEX_CHUNK];
+    jistate_t st = {0};
+    if (!buf || !handler) return false;
+    jiflat(&st, buf, len, index);
+    return jisax(&st, handler);
+}
+
+bool jsax_file(const char* filename, const jhandler_t* handler) {
+    unsigned char buf[JC_RDR_BUF_SIZE];
+    jistate_t st = {0};
+    if (!filename || !handler) return false;
+
+    size_t len; const char* map = jiopenfile(&st, filename, &len, buf);
+    if (map) {
+        unsigned short index[JC_INDEX_CHUNK];
+        jiflat(&st, map, len, index);
+        bool ok = jisax(&st, handler);
+        jiunmapfile(map, len);
+        return ok;
+    }
+
+    if (!st.fill) return false;
+    bool ok = jisax(&st, handler);
+    jiclosefile(&st);
+    return ok;
+}
+
+/* What push parser waits for between tokens */
+enum {
+    JI_EXPECT_VALUE, JI_EXPECT_FIRST_VALUE, // value, or ']' after '['
+    JI_EXPECT_KEY,   JI_EXPECT_FIRST_KEY,   // key, or '}' after '{'
+    JI_EXPECT_COLON, JI_EXPECT_NEXT,        // ',' or closing bracket
+    JI_EXPECT_END
+};
+
+/* Token being read, its head is kept in 'tok' across pieces */
+enum { JI_LEX_NONE, JI_LEX_STRING, JI_LEX_NUMBER, JI_LEX_WORD };
+
+/* Open container with its children on 'st.stk' from 'base' */
+typedef struct jipframe {
+    jvalue_t* value; size_t base;
+    const char* key; // of entry whose value is read
+} jipframe_t;
+
+struct jpush {
+    jistate_t st;
+    jisb_t frames, tok;
+    int expect, lex;
+    bool iskey, escape;
+    jvalue_t* root;
+    jpstatus_t status;
+};
+
+jpush_t* jpush_init(jarena_t* arena) {
+    jpush_t* push = JC_MALLOC(sizeof *push);
+    if (!push) return NULL;
+    memset(push, 0, sizeof *push);
+    push->st.arena = arena;
+    return push;
+}
+
+static jipframe_t* jiptop(jpush_t* p) {
+    if (!p->frames.len) return NULL;
+    return (jipframe_t*)(void*)(p->frames.ptr + p->frames.len) - 1;
+}
+
+static void jipdiscardkey(jpush_t* p, jipframe_t* frame) {
+    if (!p->st.arena) JC_FREE((void*)frame->key);
+    frame->key = NULL;
+}
+
+/* Releases unfinished tree, innermost container first */
+static void jipdrop(jpush_t* p) {
+    jipframe_t* frame;
+    while ((frame = jiptop(p)) != NULL) {
+        jidropchildren(&p->st, frame->base, frame->value->type);
+        jipdiscardkey(p, frame);
+        jidiscard(&p->st, frame->value);
+        p->frames.len -= sizeof *frame;
+    }
+    jidiscard(&p->st, p->root);
+    p->root = NULL;
+}
+
+static bool jipvalue(jpush_t* p, jvalue_t* value) {
+    jipframe_t* frame = jiptop(p);
+    if (!frame) {
+        p->root = value;
+        p->expect = JI_EXPECT_END;
+        return true;
+    }
+
+    bool ok;
+    if (frame->value->type == JT_ARRAY)
+        ok = jipushrun(&value, sizeof value, &p->st.stk);
+    else {
+        jentry_t entry = {0};
+        entry.key = frame->key;
+        entry.value = value;
+        ok = jipushrun(&entry, sizeof entry, &p->st.stk);
+        if (ok) frame->key = NULL;
+    }
+    if (!ok) jidiscard(&p->st, value);
+    p->expect = JI_EXPECT_NEXT;
+    return ok;
+}
+
+static bool jipopen(jpush_t* p, jtype_t type) {
+    jipframe_t frame = {0};
+    if (p->frames.len / sizeof frame >= JC_MAX_DEPTH) return false;
+    if (!(frame.value = jialloc(&p->st, sizeof *frame.value))) return false;
+    memset(frame.value, 0, sizeof *frame.value);
+    frame.value->type = type;
+    frame.base = p->st.stk.len;
+    if (!jipushrun(&frame, sizeof frame, &p->frames)) {
+        jidiscard(&p->st, frame.value);
+        return false;
+    }
+    p->expect = type == JT_ARRAY ? JI_EXPECT_FIRST_VALUE : JI_EXPECT_FIRST_KEY;
+    return true;
+}
+
+static bool jipclose(jpush_t* p, jtype_t type) {
+    jipframe_t* frame = jiptop(p);
+    if (!frame || frame->value->type != type) return false;
+    jipframe_t closed = *frame;
+    jvalue_t* value = closed.value;
+    p->frames.len -= sizeof closed;
+
+    bool ok = true;
+    if (p->st.stk.len == closed.base)
+        ; // empty one keeps NULL children like in jparse
+    else if (type == JT_ARRAY) {
+        value->as.array.count = (p->st.stk.len - closed.base) / sizeof(jvalue_t*);
+        value->as.array.values = jipopchildren(&p->st, closed.base, 0);
+        ok = value->as.array.values != NULL;
+        if (!ok) value->as.array.count = 0;
+    } else
+        ok = jipopentries(&p->st, value, closed.base);
+
+    if (!ok) {
+        jidropchildren(&p->st, closed.base, type);
+        jidiscard(&p->st, value);
+        return false;
+    }
+    return jipvalue(p, value);
+}
+
+/* Completes token of 'size' bytes at 'text', string without its
+ * opening quote but with closing one
+ */
+static bool jiptoken(jpush_t* p, const char* text, size_t size) {
+    jvalue_t* value = NULL;
+
+    if (p->lex == JI_LEX_STRING) {
+        const char* str; bool escaped;
+        if (jiscanstring(text, text + size, &escaped) != text + size - 1) return false;
+        size--;
+        if (p->iskey && p->st.arena) {
+            if (escaped) {
+                p->st.sb.len = 0;
+                if (!jisbrequire(&p->st.sb, size)) return false;
+                size = jiunescape(text, size, p->st.sb.ptr);
+                text = p->st.sb.ptr;
             }
+            str = jiintern(p->st.arena, text, size);
+        } else {
+            size_t room = p->iskey ? 0 : sizeof *value;
+            char* copy = jialloc(&p->st, room + size + 1);
+            if (!copy) return false;
+            value = (jvalue_t*)(void*)copy;
+            copy += room;
+            if (escaped) (void)jiunescape(text, size, copy);
+            else { memcpy(copy, text, size); copy[size] = '\0'; }
+            str = copy;
+        }
+        if (!str) return false;
 
-            if (!jiisdelim(rdr.peek(rdr.ctx))) goto error;
-            char* end; errno = 0;
-            if (value->type == JT_INTEGER)
-                value->as.integer = strtoll(buffer, &end, 10);
-            else
-                value->as.number = strtod(buffer, &end);
-            if (errno == ERANGE || buffer + size != end) goto error;
-        } break;
+        if (p->iskey) {
+            jiptop(p)->key = str;
+            p->expect = JI_EXPECT_COLON;
+            return true;
+        }
+        memset(value, 0, sizeof *value);
+        value->type = JT_STRING;
+        jisetflags(value, JI_INLINE);
+        value->as.string = str;
+        return jipvalue(p, value);
     }
-    jiskipws(rdr);
 
-    return value;
+    if (!(value = jialloc(&p->st, sizeof *value))) return false;
+    memset(value, 0, sizeof *value);
+    if (p->lex == JI_LEX_NUMBER) {
+        jistate_t num = {0};
+        num.cur = (const unsigned char*)text;
+        num.end = (const unsigned char*)text + size;
+        if (!jiparsenumber(&num, value) || num.cur != num.end) goto error;
+    } else {
+        /**/ if (size == 4 && memcmp(text, "null", 4) == 0) value->type = JT_NULL;
+        else if (size == 4 && memcmp(text, "true", 4) == 0) {
+            value->type = JT_BOOLEAN;
+            value->as.boolean = true;
+        } else if (size == 5 && memcmp(text, "false", 5) == 0)
+            value->type = JT_BOOLEAN;
+        else
+            goto error;
+    }
+    return jipvalue(p, value);
 error:
-    jfree(value);
-    return NULL;
+    jidiscard(&p->st, value);
+    return false;
 }
 
-jvalue_t* jparse(jreader_t rdr) {
-    jvalue_t* json = jiparsevalue(rdr);
-    if (!json) return json;
-    if (rdr.next(rdr.ctx) < 0)
-        return json;
-    jfree(json);
-    return NULL;
+/* Reads rest of token from 'cur', leaves 'cur' after it or
+ * keeps the head of token when piece ends
+ */
+static bool jipscan(jpush_t* p, const char** curptr, const char* end) {
+    const char *begin = *curptr, *cur = begin;
+
+    if (p->lex == JI_LEX_STRING) {
+        for (; cur < end; ++cur) {
+            /**/ if (p->escape) p->escape = false;
+            else if (*cur == '\\') p->escape = true;
+            else if (*cur == '"') break;
+        }
+        if (cur < end) ++cur; // closing quote is a part of token
+        else goto more;
+    } else {
+        bool number = p->lex == JI_LEX_NUMBER;
+        while (cur < end && (number ? jiisnumchar(*cur) : (*cur >= 'a' && *cur <= 'z'))) ++cur;
+        if (cur == end) goto more;
+    }
+
+    *curptr = cur;
+    if (p->tok.len) {
+        if (!jipushrun(begin, cur - begin, &p->tok)) return false;
+        begin = p->tok.ptr;
+        cur = p->tok.ptr + p->tok.len;
+        p->tok.len = 0;
+    }
+    bool ok = jiptoken(p, begin, cur - begin);
+    p->lex = JI_LEX_NONE;
+    return ok;
+more:
+    *curptr = end;
+    return begin == end || jipushrun(begin, end - begin, &p->tok);
+}
+
+static bool jipstep(jpush_t* p, const char** curptr, const char* end) {
+    const char* cur = *curptr;
+    jipframe_t* frame;
+    int ch = (unsigned char)*cur++;
+    *curptr = cur;
+
+    switch (p->expect) {
+        case JI_EXPECT_FIRST_VALUE:
+            if (ch == ']') return jipclose(p, JT_ARRAY);
+            /* fallthrough */
+        case JI_EXPECT_VALUE:
+            if (ch == '{') return jipopen(p, JT_OBJECT);
+            if (ch == '[') return jipopen(p, JT_ARRAY);
+            p->iskey = false;
+            /**/ if (ch == '"') p->lex = JI_LEX_STRING;
+            else if (ch == '-' || jiisdec(ch)) p->lex = JI_LEX_NUMBER;
+            else if (ch >= 'a' && ch <= 'z') p->lex = JI_LEX_WORD;
+            else return false;
+            if (p->lex != JI_LEX_STRING) *curptr = --cur;
+            return jipscan(p, curptr, end);
+
+        case JI_EXPECT_FIRST_KEY:
+            if (ch == '}') return jipclose(p, JT_OBJECT);
+            /* fallthrough */
+        case JI_EXPECT_KEY:
+            if (ch != '"') return false;
+            p->iskey = true;
+            p->lex = JI_LEX_STRING;
+            return jipscan(p, curptr, end);
+
+        case JI_EXPECT_COLON:
+            if (ch != ':') return false;
+            p->expect = JI_EXPECT_VALUE;
+            return true;
+
+        case JI_EXPECT_NEXT:
+            frame = jiptop(p);
+            if (ch == ']' || ch == '}')
+                return jipclose(p, ch == ']' ? JT_ARRAY : JT_OBJECT);
+            if (ch != ',') return false;
+            p->expect = frame->value->type == JT_ARRAY ? JI_EXPECT_VALUE : JI_EXPECT_KEY;
+            return true;
+
+        default: return false;
+    }
+}
+
+jpstatus_t jpush_feed(jpush_t* p, const char* data, size_t len) {
+    if (!p || (!data && len)) return JP_ERROR;
+    if (p->status != JP_MORE && p->status != JP_DONE) return p->status;
+    const char *cur = data, *end = data + len;
+
+    while (cur < end) {
+        if (p->lex != JI_LEX_NONE) {
+            if (!jipscan(p, &cur, end)) goto error;
+            continue;
+        }
+        if (jiisspace((unsigned char)*cur)) { ++cur; continue; }
+        if (!jipstep(p, &cur, end)) goto error;
+    }
+
+    p->status = p->expect == JI_EXPECT_END ? JP_DONE : JP_MORE;
+    return p->status;
+error:
+    jipdrop(p);
+    p->status = JP_ERROR;
+    return p->status;
+}
+
+jpstatus_t jpush_finish(jpush_t* p) {
+    if (!p) return JP_ERROR;
+    if (p->status != JP_MORE && p->status != JP_DONE) return p->status;
+
+    if (p->lex == JI_LEX_NUMBER || p->lex == JI_LEX_WORD) {
+        bool ok = jiptoken(p, p->tok.ptr, p->tok.len);
+        p->tok.len = 0;
+        p->lex = JI_LEX_NONE;
+        if (!ok) goto error;
+    }
+    if (p->lex != JI_LEX_NONE || p->expect != JI_EXPECT_END) goto error;
+    return p->status = JP_DONE;
+error:
+    jipdrop(p);
+    return p->status = JP_ERROR;
 }
 
-static int jirdrstrnext(void* ptr) {
-    union { void* v; const char** s; } conv = {.v = ptr};
-    return **conv.s ? *(*conv.s)++ : -1;
+jvalue_t* jpush_value(jpush_t* p) {
+    if (!p || p->status != JP_DONE || p->lex != JI_LEX_NONE) return NULL;
+    jvalue_t* value = p->root;
+    p->root = NULL;
+    return value;
 }
 
-static int jirdrstrpeek(void* ptr) {
-    union { void* v; const char** s; } conv = {.v = ptr};
-    return **conv.s ? **conv.s : -1;
+void jpush_free(jpush_t* p) {
+    if (!p) return;
+    jipdrop(p);
+    JC_FREE(p->st.sb.ptr);
+    JC_FREE(p->st.stk.ptr);
+    JC_FREE(p->frames.ptr);
+    JC_FREE(p->tok.ptr);
+    JC_FREE(p);
 }
 
-jvalue_t* jparse_cstr(const char* str) {
-    if (!str) return NULL;
-    return jparse((jreader_t){
-        jirdrstrnext, jirdrstrpeek, &str
-    });
+jlexer_t jlexer(const char* buf, size_t len) {
+    jlexer_t lexer = {0};
+    if (buf) {
+        lexer.cur = buf;
+        lexer.end = buf + len;
+    } return lexer;
+}
+
+jtoken_t jlex(jlexer_t* lexer) {
+    jtoken_t token = {0};
+    const char *cur, *end;
+    if (!lexer || !lexer->cur) {
+        token.type = JK_ERROR;
+        return token;
+    }
+
+    cur = lexer->cur; end = lexer->end;
+    while (cur < end && jiisspace(*cur)) ++cur;
+    token.start = cur;
+    if (cur >= end) {
+        lexer->cur = cur;
+        return token;
+    }
+
+    switch (*cur) {
+        case '{': token.type = JK_OBJECT_BEGIN; ++cur; break;
+        case '}': token.type = JK_OBJECT_END;   ++cur; break;
+        case '[': token.type = JK_ARRAY_BEGIN;  ++cur; break;
+        case ']': token.type = JK_ARRAY_END;    ++cur; break;
+        case ':': token.type = JK_COLON;        ++cur; break;
+        case ',': token.type = JK_COMMA;        ++cur; break;
+        case '"': {
+            token.type = JK_STRING;
+            token.start = ++cur;
+            cur = jiscanstring(cur, end, &token.escaped);
+            if (!cur) goto error;
+            token.length = cur++ - token.start;
+            if (cur < end && !jiisdelim(*cur) && *cur != ':') goto error;
+        } goto done;
+        case 'n': case 'f': case 't': {
+            static const char* const keywords[] = {"null", "false", "true"};
+            jtoktype_t type = *cur == 'n' ? JK_NULL : *cur == 'f' ? JK_FALSE : JK_TRUE;
+            const char* kw = keywords[type - JK_NULL];
+            while (*kw && cur < end && *cur == *kw) ++cur, ++kw;
+            if (*kw) goto error;
+            token.type = type;
+        } goto scalar;
+        default: {
+            bool integer;
+            cur = jiscannumber(cur, end, &integer);
+            if (!cur) goto error;
+            token.type = integer ? JK_INTEGER : JK_NUMBER;
+        } goto scalar;
+    }
+    token.length = 1;
+    goto done;
+
+scalar:
+    token.length = cur - token.start;
+    if (cur < end && !jiisdelim(*cur)) goto error;
+done:
+    lexer->cur = cur;
+    return token;
+error:
+    token.type = JK_ERROR;
+    token.length = 0;
+    return token;
 }
 
-static int jirdrfilenext(void* ptr) {
-    union { void* v; FILE* f; } conv = {.v = ptr};
-    return fgetc(conv.f);
+size_t jtoken_string(const jtoken_t* token, char* buf) {
+    if (!token || !buf || token->type != JK_STRING) return 0;
+    if (!token->escaped) {
+        memcpy(buf, token->start, token->length);
+        buf[token->length] = '\0';
+        return token->length;
+    }
+    return jiunescape(token->start, token->length, buf);
 }
 
-static int jirdrfilepeek(void* ptr) {
-    union { void* v; FILE* f; } conv = {.v = ptr};
-    return ungetc(fgetc(conv.f), conv.f);
+static bool jitokennumber(const jtoken_t* token, jvalue_t* value) {
+    jistate_t st = {0};
+    if (!token || (token->type != JK_INTEGER && token->type != JK_NUMBER))
+        return false;
+    st.cur = (const unsigned char*)token->start;
+    st.end = (const unsigned char*)token->start + token->length;
+    return jiparsenumber(&st, value);
 }
 
-jvalue_t* jparse_file(const char* filename) {
-    FILE* fd = fopen(filename, "r");
-    if (!fd) return NULL;
-    jvalue_t* json = jparse((jreader_t){
-        jirdrfilenext, jirdrfilepeek, fd
-    }); fclose(fd);
-    return json;
+bool jtoken_integer(const jtoken_t* token, long long* integer) {
+    jvalue_t value;
+    if (!integer || !jitokennumber(token, &value)) return false;
+    if (value.type != JT_INTEGER) return false;
+    *integer = value.as.integer;
+    return true;
+}
+
+bool jtoken_number(const jtoken_t* token, double* number) {
+    jvalue_t value;
+    if (!number || !jitokennumber(token, &value)) return false;
+    *number = value.type == JT_INTEGER
+        ? (double)value.as.integer : value.as.number;
+    return true;
+}
+
+static void jibuildindex(jobject_t* obj) {
+    unsigned* hashes = (unsigned*)(void*)(obj->entries + obj->count);
+    unsigned* slots = hashes + obj->count;
+    size_t mask = jislots(obj->count) - 1;
+
+    memset(slots, 0, (mask + 1) * sizeof *slots);
+    for (size_t i = 0; i < obj->count; i++) {
+        size_t slot = (hashes[i] = jihash(obj->entries[i].key)) & mask;
+        while (slots[slot]) slot = (slot + 1) & mask;
+        slots[slot] = (unsigned)i + 1;
+    }
+}
+
+/* Looks up key in object, by its 'hash' if known */
+static jvalue_t* jiat(jvalue_t* obj, const char* key, const unsigned* hashptr) {
+    jobject_t* o = &obj->as.object;
+
+    if (!(jiflags(obj) & JI_ROOMY)) {
+        for (size_t i = 0; i < o->count; i++)
+            if (o->entries[i].key == key || strcmp(o->entries[i].key, key) == 0)
+                return o->entries[i].value;
+        return NULL;
+    }
+
+    if (!(jiflags(obj) & JI_HASHED)) {
+        jibuildindex(o);
+        jisetflags(obj, jiflags(obj) | JI_HASHED);
+    }
+
+    unsigned* hashes = (unsigned*)(void*)(o->entries + o->count);
+    unsigned* slots = hashes + o->count;
+    size_t mask = jislots(o->count) - 1;
+    unsigned hash = hashptr ? *hashptr : jihash(key);
+
+    for (size_t slot = hash & mask; slots[slot]; slot = (slot + 1) & mask) {
+        unsigned i = slots[slot] - 1;
+        if (o->entries[i].key == key
+        || (hashes[i] == hash && strcmp(o->entries[i].key, key) == 0))
+            return o->entries[i].value;
+    }
+    return NULL;
 }
 
 jvalue_t* jat(jvalue_t* obj, const char* key) {
     if (!key || !obj || obj->type != JT_OBJECT) return NULL;
-    jentry_t kentry = {0}; kentry.key = (char*)key;
-    jentry_t* find = bsearch(&kentry,
-        obj->as.object.entries, obj->as.object.count,
-        sizeof *obj->as.object.entries, jientrycmp);
-    return find ? find->value : NULL;
+    return jiat(obj, key, NULL);
 }
 
 jvalue_t* (jpath)(jvalue_t* value, size_t depth, ...) {
@@ -456,7 +2429,7 @@ jvalue_t* (jpath)(jvalue_t* value, size_t depth, ...) {
             value = jat(value, key);
         } else if (value->type == JT_ARRAY) {
             size_t index = va_arg(args, size_t);
-            if (index >= value->as.array.count) goto error;
+            if (index >= value->as.array.count || jpacked(value)) goto error;
             value = value->as.array.values[index];
         } else
             goto error;
@@ -469,63 +2442,1743 @@ error:
     return NULL;
 }
 
-void (jprint)(jvalue_t* value, unsigned level) {
-    if (!value) return;
-    switch (value->type) {
-        case JT_NULL: fputs("null", stdout); break;
-        case JT_BOOLEAN: fputs(value->as.boolean ? "true" : "false", stdout); break;
-        case JT_INTEGER: printf("%lli", value->as.integer); break;
-        case JT_NUMBER: printf("%lg", value->as.number); break;
-        case JT_STRING: printf("\"%s\"", value->as.string); break;
-        case JT_ARRAY: {
-            putchar('[');
-            if (value->as.array.count == 0) { putchar(']'); break; }
-            putchar('\n');
-            for (size_t i = 0; i < value->as.array.count; i++) {
-                printf("%*s", (level + 1) * JC_TAB_SIZE, "");
-                (jprint)(value->as.array.values[i], level + 1);
-                if (i < value->as.array.count - 1) putchar(',');
-                putchar('\n');
+#define JI_QKEY   1 // step applies to object
+#define JI_QINDEX 2 // step applies to array
+
+typedef struct jiqstep {
+    int kind; size_t index;
+    const char* key; size_t keyat; // offset of key while compiling
+    unsigned hash;
+} jiqstep_t;
+
+struct jquery {
+    size_t count;
+    jiqstep_t steps[];
+};
+
+typedef struct jiqbuilder { jisb_t steps, keys; } jiqbuilder_t;
+
+static void jiqkeybegin(jiqbuilder_t* b, jiqstep_t* step) {
+    step->kind |= JI_QKEY;
+    step->keyat = b->keys.len;
+}
+
+static bool jiqpush(jiqbuilder_t* b, jiqstep_t* step) {
+    if (step->kind & JI_QKEY) {
+        if (!jipushchar('\0', &b->keys)) return false;
+        step->hash = jihash(b->keys.ptr + step->keyat);
+    }
+    return jipushrun(step, sizeof *step, &b->steps);
+}
+
+/* Non-negative decimal without leading zeros */
+static bool jiqindex(const char* cur, const char* end, size_t* index) {
+    if (cur == end || (*cur == '0' && end - cur > 1)) return false;
+    for (*index = 0; cur < end; ++cur) {
+        if (!jiisdec(*cur) || *index > (SIZE_MAX - 9) / 10) return false;
+        *index = *index * 10 + (*cur - '0');
+    }
+    return true;
+}
+
+static bool jiqpointer(jiqbuilder_t* b, const char* cur) {
+    while (*cur == '/') {
+        jiqstep_t step = {0};
+        const char* end = ++cur;
+        while (*end && *end != '/') ++end;
+        if (jiqindex(cur, end, &step.index)) step.kind |= JI_QINDEX;
+
+        jiqkeybegin(b, &step);
+        for (; cur < end; ++cur) {
+            int ch = *cur;
+            if (ch == '~') {
+                /**/ if (cur[1] == '0') ch = '~';
+                else if (cur[1] == '1') ch = '/';
+                else return false;
+                ++cur;
             }
-            printf("%*s]", level * JC_TAB_SIZE, "");
-        } break;
-        case JT_OBJECT: {
-            putchar('{');
-            if (value->as.object.count == 0) { putchar('}'); break; }
-            putchar('\n');
-            for (size_t i = 0; i < value->as.object.count; i++) {
-                jentry_t entry = value->as.object.entries[i];
-                printf("%*s\"%s\": ", (level + 1) * JC_TAB_SIZE, "", entry.key);
-                (jprint)(entry.value, level + 1);
-                if (i < value->as.object.count - 1) putchar(',');
-                putchar('\n');
+            if (!jipushchar(ch, &b->keys)) return false;
+        }
+        if (!jiqpush(b, &step)) return false;
+    }
+    return *cur == '\0';
+}
+
+static bool jiqjsonpath(jiqbuilder_t* b, const char* cur) {
+    while (*cur) {
+        jiqstep_t step = {0};
+        if (*cur == '.') {
+            const char* end = ++cur;
+            while (*end && *end != '.' && *end != '[') ++end;
+            if (end == cur) return false;
+            jiqkeybegin(b, &step);
+            if (!jipushrun(cur, end - cur, &b->keys)) return false;
+            cur = end;
+        } else if (*cur == '[' && (cur[1] == '\'' || cur[1] == '"')) {
+            char quote = cur[1];
+            jiqkeybegin(b, &step);
+            for (cur += 2; *cur != quote; ++cur) {
+                if (*cur == '\\' && (cur[1] == quote || cur[1] == '\\')) ++cur;
+                if (!*cur || !jipushchar(*cur, &b->keys)) return false;
             }
-            printf("%*s}", level * JC_TAB_SIZE, "");
-        } break;
+            if (*++cur != ']') return false;
+            ++cur;
+        } else if (*cur == '[') {
+            const char* end = ++cur;
+            while (jiisdec(*end)) ++end;
+            if (*end != ']' || !jiqindex(cur, end, &step.index)) return false;
+            step.kind = JI_QINDEX;
+            cur = end + 1;
+        } else
+            return false;
+        if (!jiqpush(b, &step)) return false;
     }
+    return true;
 }
 
-void jfree(jvalue_t* value) {
-    if (!value) return;
-    switch (value->type) {
-        case JT_NULL: case JT_BOOLEAN:
-        case JT_INTEGER: case JT_NUMBER: break;
+jquery_t* jqcompile(const char* path) {
+    jiqbuilder_t b = {0};
+    jquery_t* query = NULL;
+    bool ok;
+    if (!path) return NULL;
 
-        case JT_STRING: free((void*)value->as.string); break;
-        case JT_ARRAY: {
-            for (size_t i = 0; i < value->as.array.count; i++)
+    if (*path == '$') ok = jiqjsonpath(&b, path + 1);
+    else ok = jiqpointer(&b, path);
+    if (!ok) goto cleanup;
+
+    size_t count = b.steps.len / sizeof(jiqstep_t);
+    query = JC_MALLOC(sizeof *query + b.steps.len + b.keys.len);
+    if (!query) goto cleanup;
+    query->count = count;
+    if (count) memcpy(query->steps, b.steps.ptr, b.steps.len);
+
+    char* keys = (char*)(query->steps + count);
+    if (b.keys.len) memcpy(keys, b.keys.ptr, b.keys.len);
+    for (size_t i = 0; i < count; i++)
+        if (query->steps[i].kind & JI_QKEY)
+            query->steps[i].key = keys + query->steps[i].keyat;
+
+cleanup:
+    JC_FREE(b.steps.ptr);
+    JC_FREE(b.keys.ptr);
+    return query;
+}
+
+jvalue_t* jqeval(const jquery_t* query, jvalue_t* value) {
+    if (!query) return NULL;
+    for (size_t i = 0; value && i < query->count; i++) {
+        const jiqstep_t* step = &query->steps[i];
+        /**/ if (value->type == JT_OBJECT && (step->kind & JI_QKEY))
+            value = jiat(value, step->key, &step->hash);
+        else if (value->type == JT_ARRAY && (step->kind & JI_QINDEX))
+            value = step->index < value->as.array.count && !jpacked(value)
+                ? value->as.array.values[step->index] : NULL;
+        else
+            value = NULL;
+    }
+    return value;
+}
+
+void jqfree(jquery_t* query) {
+    JC_FREE(query);
+}
+
+/* Skips value at flat input cursor, matching only brackets */
+static bool jiskipvalue(jistate_t* st) {
+    const char* cur = (const char*)st->cur;
+    const char* end = (const char*)st->end;
+    size_t depth = 0; bool escaped;
+
+    do {
+        if (cur >= end) return false;
+        switch (*cur) {
+            case '"':
+                cur = jiscanstring(cur + 1, end, &escaped);
+                if (!cur) return false;
+                ++cur; break;
+            case '[': case '{': ++depth; ++cur; break;
+            case ']': case '}':
+                if (depth-- == 0) return false;
+                ++cur; break;
+            default:
+                if (depth) ++cur;
+                else while (cur < end && !jiisdelim((unsigned char)*cur)) ++cur;
+        }
+    } while (depth);
+
+    st->cur = (const unsigned char*)cur;
+    return true;
+}
+
+static bool jikeyequal(jistate_t* st, const char* begin, const char* end, bool escaped, const char* key) {
+    if (escaped) {
+        st->sb.len = 0;
+        if (!jisbrequire(&st->sb, end - begin)) return false;
+        end = st->sb.ptr + jiunescape(begin, end - begin, st->sb.ptr);
+        begin = st->sb.ptr;
+    }
+    for (; begin < end; ++begin, ++key)
+        if (*key == '\0' || *begin != *key) return false;
+    return *key == '\0';
+}
+
+/* Leaves cursor at value of first 'key' in object */
+static bool jifindkey(jistate_t* st, const char* key) {
+    const char *begin, *end; bool escaped, found;
+    jiskipws(st);
+    if (jipeek(st) == '}') return false;
+
+    while (true) {
+        if (jinext(st) != '"') return false;
+        begin = (const char*)st->cur;
+        end = jiscanstring(begin, (const char*)st->end, &escaped);
+        if (!end) return false;
+        st->cur = (const unsigned char*)end + 1;
+        found = key && jikeyequal(st, begin, end, escaped, key);
+
+        jiskipws(st);
+        if (jinext(st) != ':') return false;
+        jiskipws(st);
+        if (found) return true;
+
+        if (!jiskipvalue(st)) return false;
+        jiskipws(st);
+        if (jinext(st) != ',') return false;
+        jiskipws(st);
+    }
+}
+
+/* Leaves cursor at element 'index' of array */
+static bool jifindindex(jistate_t* st, size_t index) {
+    jiskipws(st);
+    if (jipeek(st) == ']') return false;
+    for (; index > 0; index--) {
+        if (!jiskipvalue(st)) return false;
+        jiskipws(st);
+        if (jinext(st) != ',') return false;
+        jiskipws(st);
+    }
+    return true;
+}
+
+jvalue_t* (jfind)(jarena_t* arena, const char* buf, size_t len, size_t depth, ...) {
+    jistate_t st = {0};
+    jvalue_t* json = NULL;
+    va_list args;
+    if (!buf) return NULL;
+
+    jiblock_t* top = arena ? arena->top : NULL;
+    char* begin = top ? top->begin : NULL;
+    size_t keycount = arena ? arena->keycount : 0;
+
+    st.cur = (const unsigned char*)buf;
+    st.end = (const unsigned char*)buf + len;
+    st.arena = arena;
+    va_start(args, depth);
+
+    while (depth --> 0) {
+        jiskipws(&st);
+        int ch = jinext(&st);
+        /**/ if (ch == '{') {
+            if (!jifindkey(&st, va_arg(args, const char*))) goto done;
+        } else if (ch == '[') {
+            if (!jifindindex(&st, va_arg(args, size_t))) goto done;
+        } else
+            goto done;
+    }
+
+    json = jiparsevalue(&st);
+    if (!json && arena) {
+        jiarenarewind(arena, top, begin);
+        if (arena->keycount != keycount) jiforgetkeys(arena);
+    }
+
+done:
+    va_end(args);
+    JC_FREE(st.sb.ptr);
+    JC_FREE(st.stk.ptr);
+    return json;
+}
+
+static bool jiskipkeyword(jistate_t* st, const char* kw, size_t len) {
+    if ((size_t)(st->end - st->cur) < len || memcmp(st->cur, kw, len) != 0) return false;
+    st->cur += len;
+    return jiisdelim(jipeek(st));
+}
+
+/* Checks value at flat input without building it, on failure
+ * input stays at the bad byte or the start of bad scalar
+ */
+static bool jiskipvalid(jistate_t* st, unsigned depth) {
+    const char* end; bool flag; int ch;
+    if (depth > JC_MAX_DEPTH) return false;
+    jiskipws(st);
+    switch (jipeek(st)) {
+        case 'n': return jiskipkeyword(st, "null", 4);
+        case 'f': return jiskipkeyword(st, "false", 5);
+        case 't': return jiskipkeyword(st, "true", 4);
+        case '"':
+            end = jiscanstring((const char*)st->cur + 1, (const char*)st->end, &flag);
+            if (!end) return false;
+            st->cur = (const unsigned char*)end + 1;
+            return true;
+        case '[':
+            (void)jinext(st);
+            jiskipws(st);
+            if (jipeek(st) == ']') { (void)jinext(st); return true; }
+            while (true) {
+                if (!jiskipvalid(st, depth + 1)) return false;
+                jiskipws(st);
+                if ((ch = jipeek(st)) != ',') break;
+                (void)jinext(st);
+            }
+            if (ch != ']') return false;
+            (void)jinext(st);
+            return true;
+        case '{':
+            (void)jinext(st);
+            jiskipws(st);
+            if (jipeek(st) == '}') { (void)jinext(st); return true; }
+            while (true) {
+                jiskipws(st);
+                if (jipeek(st) != '"' || !jiskipvalid(st, depth + 1)) return false;
+                jiskipws(st);
+                if (jipeek(st) != ':') return false;
+                (void)jinext(st);
+                if (!jiskipvalid(st, depth + 1)) return false;
+                jiskipws(st);
+                if ((ch = jipeek(st)) != ',') break;
+                (void)jinext(st);
+            }
+            if (ch != '}') return false;
+            (void)jinext(st);
+            return true;
+        default: {
+            const char* text = (const char*)st->cur;
+            end = jiscannumber(text, (const char*)st->end, &flag);
+            if (!end || !jinumberfits(text, end - text, flag)) return false;
+            st->cur = (const unsigned char*)end;
+            return jiisdelim(jipeek(st));
+        }
+    }
+}
+
+bool jvalidate(const char* buf, size_t len, size_t* offset) {
+    unsigned short index[JC_INDEX_CHUNK];
+    jistate_t st = {0};
+    if (!buf) return false;
+    jiflat(&st, buf, len, index);
+
+    bool ok = jiskipvalid(&st, 0);
+    if (ok) {
+        jiskipws(&st);
+        ok = st.cur == st.end;
+    }
+    if (!ok && offset) *offset = (const char*)st.cur - buf;
+    return ok;
+}
+
+static const jfield_t* jibindmatch(jistate_t* st, const jfield_t* from, const jfield_t* to,
+    const char* key, size_t len) {
+    for (; from != to && from->type != JB_END; ++from)
+        if (jikeyequal(st, key, key + len, false, from->name)) return from;
+    return NULL;
+}
+
+/* Reads key and finds its field, NULL if there is none. Keys
+ * mostly come in table order, so search starts past the last one
+ */
+static bool jibindkey(jistate_t* st, const jfield_t* fields, const jfield_t** hint, const jfield_t** field) {
+    const char *begin, *end; bool escaped;
+    if (jinext(st) != '"') return false;
+    begin = (const char*)st->cur;
+    end = jiscanstring(begin, (const char*)st->end, &escaped);
+    if (!end) return false;
+    st->cur = (const unsigned char*)end + 1;
+    if (escaped) {
+        st->sb.len = 0;
+        if (!jisbrequire(&st->sb, end - begin)) return false;
+        end = st->sb.ptr + jiunescape(begin, end - begin, st->sb.ptr);
+        begin = st->sb.ptr;
+    }
+
+    *field = jibindmatch(st, *hint, NULL, begin, end - begin);
+    if (!*field) *field = jibindmatch(st, fields, *hint, begin, end - begin);
+    if (*field) *hint = *field + 1;
+    return true;
+}
+
+static void jibindrelease(const jfield_t* field, char* base) {
+    char* dst = base + field->offset;
+    switch (field->type) {
+        case JB_STRING:
+            JC_FREE(*(char**)(void*)dst);
+            *(char**)(void*)dst = NULL;
+            break;
+        case JB_OBJECT:
+            for (const jfield_t* f = field->fields; f->type != JB_END; ++f)
+                jibindrelease(f, dst);
+            break;
+        case JB_ARRAY: {
+            char* items = *(char**)(void*)dst;
+            size_t* count = (size_t*)(void*)(base + field->count);
+            for (size_t i = 0; i < *count; i++)
+                jibindrelease(field->fields, items + i * field->size);
+            JC_FREE(items);
+            *(char**)(void*)dst = NULL;
+            *count = 0;
+        } break;
+        default: break;
+    }
+}
+
+static bool jibindobject(jistate_t* st, const jfield_t* fields, char* base, unsigned depth);
+
+/* Binds value at input into 'field' of struct at 'base' */
+static bool jibindvalue(jistate_t* st, const jfield_t* field, char* base, unsigned depth) {
+    char* dst = base + field->offset;
+    jvalue_t num;
+
+    jiskipws(st);
+    if (jipeek(st) == 'n') {
+        if (!jiparsekeyword(st, "null")) return false;
+        jiskipws(st);
+        return true;
+    }
+
+    switch (field->type) {
+        case JB_BOOL: {
+            bool boolean = jipeek(st) == 't';
+            if (!jiparsekeyword(st, boolean ? "true" : "false")) return false;
+            *(bool*)(void*)dst = boolean;
+        } break;
+        case JB_INT: case JB_LLONG: case JB_DOUBLE: {
+            int ch = jipeek(st);
+            if (ch != '-' && !jiisdec(ch)) return false;
+            if (!jiparsenumber(st, &num)) return false;
+            if (field->type == JB_DOUBLE)
+                *(double*)(void*)dst = num.type == JT_INTEGER
+                    ? (double)num.as.integer : num.as.number;
+            else if (num.type != JT_INTEGER) return false;
+            else if (field->type == JB_LLONG) *(long long*)(void*)dst = num.as.integer;
+            else if (INT_MIN <= num.as.integer && num.as.integer <= INT_MAX)
+                *(int*)(void*)dst = (int)num.as.integer;
+            else return false;
+        } break;
+        case JB_STRING: {
+            const char* str;
+            if (jipeek(st) != '"' || !jiparsestring(st, &str, false, 0)) return false;
+            JC_FREE(*(char**)(void*)dst);
+            *(char**)(void*)dst = (char*)str;
+        } break;
+        case JB_OBJECT: {
+            if (jipeek(st) != '{') return false;
+            if (!jibindobject(st, field->fields, dst, depth + 1)) return false;
+        } break;
+        case JB_ARRAY: {
+            char* items = NULL;
+            size_t count = 0, cap = 0, size = field->size;
+            int ch;
+            if (jinext(st) != '[' || depth >= JC_MAX_DEPTH) return false;
+            jiskipws(st);
+            if (jipeek(st) != ']') {
+                do {
+                    if (count == cap) {
+                        cap = cap ? cap * 2 : 4;
+                        void* new = cap <= SIZE_MAX / size ? JC_REALLOC(items, cap * size) : NULL;
+                        if (!new) goto error_arr;
+                        items = new;
+                    }
+                    memset(items + count * size, 0, size);
+                    ++count;
+                    if (!jibindvalue(st, field->fields, items + (count - 1) * size, depth + 1))
+                        goto error_arr;
+                } while ((ch = jinext(st)) == ',');
+            } else ch = jinext(st);
+            if (ch != ']') goto error_arr;
+
+            jibindrelease(field, base);
+            *(char**)(void*)dst = items;
+            *(size_t*)(void*)(base + field->count) = count;
+            break;
+        error_arr:
+            for (size_t i = 0; i < count; i++)
+                jibindrelease(field->fields, items + i * size);
+            JC_FREE(items);
+            return false;
+        } break;
+        default: return false;
+    }
+    jiskipws(st);
+    return true;
+}
+
+static bool jibindobject(jistate_t* st, const jfield_t* fields, char* base, unsigned depth) {
+    const jfield_t *hint = fields, *field;
+    int ch;
+    if (depth > JC_MAX_DEPTH || jinext(st) != '{') return false;
+    jiskipws(st);
+    if (jipeek(st) == '}') return jinext(st) == '}';
+
+    do {
+        jiskipws(st);
+        if (!jibindkey(st, fields, &hint, &field)) return false;
+        jiskipws(st);
+        if (jinext(st) != ':') return false;
+        if (field) {
+            if (!jibindvalue(st, field, base, depth)) return false;
+        } else {
+            if (!jiskipvalid(st, depth + 1)) return false;
+            jiskipws(st);
+        }
+    } while ((ch = jinext(st)) == ',');
+    return ch == '}';
+}
+
+bool jbind(const char* buf, size_t len, const jfield_t* fields, void* object) {
+    unsigned short index[JC_INDEX_CHUNK];
+    jistate_t st = {0};
+    if (!buf || !fields || !object) return false;
+    jiflat(&st, buf, len, index);
+
+    jiskipws(&st);
+    bool ok = jibindobject(&st, fields, object, 0);
+    if (ok) {
+        jiskipws(&st);
+        ok = jinext(&st) < 0;
+    }
+    JC_FREE(st.sb.ptr);
+    return ok;
+}
+
+void jbind_free(const jfield_t* fields, void* object) {
+    if (!object) return;
+    for (; fields && fields->type != JB_END; ++fields)
+        jibindrelease(fields, object);
+}
+
+#define JI_TAG(word) ((int)((word) >> 56))
+#define JI_WORD(tag, payload) ((uint64_t)(tag) << 56 | (uint64_t)(payload))
+#define JI_COUNT_MAX 0xFFFFFFu // count of longer container is walked
+
+/* Tape is built from sax events, open containers are on 'stack'
+ * and get their end position and count when closed
+ */
+typedef struct jitapeopen { size_t at, count; } jitapeopen_t;
+typedef struct jitapebuilder { jisb_t words, strings, stack; } jitapebuilder_t;
+
+static bool jitapeword(jitapebuilder_t* b, uint64_t word) {
+    return jipushrun(&word, sizeof word, &b->words);
+}
+
+static void jitapeelement(jitapebuilder_t* b) {
+    if (!b->stack.len) return;
+    jitapeopen_t* top = (jitapeopen_t*)(void*)(b->stack.ptr + b->stack.len) - 1;
+    if (JI_TAG(((uint64_t*)(void*)b->words.ptr)[top->at]) == '[') top->count++;
+}
+
+static bool jitapebegin(jitapebuilder_t* b, int tag) {
+    jitapeopen_t open = {0};
+    jitapeelement(b);
+    open.at = b->words.len / sizeof(uint64_t);
+    return jipushrun(&open, sizeof open, &b->stack) && jitapeword(b, JI_WORD(tag, 0));
+}
+
+static bool jitapeend(jitapebuilder_t* b, int tag) {
+    size_t end = b->words.len / sizeof(uint64_t);
+    if (end > UINT32_MAX) return false;
+    b->stack.len -= sizeof(jitapeopen_t);
+    jitapeopen_t* open = (jitapeopen_t*)(void*)(b->stack.ptr + b->stack.len);
+    uint64_t* begin = (uint64_t*)(void*)b->words.ptr + open->at;
+    size_t count = open->count < JI_COUNT_MAX ? open->count : JI_COUNT_MAX;
+    *begin = JI_WORD(JI_TAG(*begin), (uint64_t)count << 32 | end);
+    return jitapeword(b, JI_WORD(tag, open->at));
+}
+
+static bool jitapestring(jitapebuilder_t* b, int tag, const char* str, size_t len) {
+    return jitapeword(b, JI_WORD(tag, b->strings.len))
+        && jipushrun(str, len + 1, &b->strings);
+}
+
+static bool jitapeobjbegin(void* b) { return jitapebegin(b, '{'); }
+static bool jitapeobjend  (void* b) { return jitapeend(b, '}'); }
+static bool jitapearrbegin(void* b) { return jitapebegin(b, '['); }
+static bool jitapearrend  (void* b) { return jitapeend(b, ']'); }
+
+static bool jitapekey(void* ctx, const char* key, size_t len) {
+    jitapebuilder_t* b = ctx;
+    ((jitapeopen_t*)(void*)(b->stack.ptr + b->stack.len) - 1)->count++;
+    return jitapestring(b, 'k', key, len);
+}
+
+static bool jitapestr(void* ctx, const char* str, size_t len) {
+    jitapeelement(ctx);
+    return jitapestring(ctx, '"', str, len);
+}
+
+static bool jitapeint(void* ctx, long long integer) {
+    uint64_t bits; memcpy(&bits, &integer, sizeof bits);
+    jitapeelement(ctx);
+    return jitapeword(ctx, JI_WORD('l', 0)) && jitapeword(ctx, bits);
+}
+
+static bool jitapenum(void* ctx, double number) {
+    uint64_t bits; memcpy(&bits, &number, sizeof bits);
+    jitapeelement(ctx);
+    return jitapeword(ctx, JI_WORD('d', 0)) && jitapeword(ctx, bits);
+}
+
+static bool jitapebool(void* ctx, bool boolean) {
+    jitapeelement(ctx);
+    return jitapeword(ctx, JI_WORD(boolean ? 't' : 'f', 0));
+}
+
+static bool jitapenull(void* ctx) {
+    jitapeelement(ctx);
+    return jitapeword(ctx, JI_WORD('n', 0));
+}
+
+jtape_t* jtape(const char* buf, size_t len) {
+    jitapebuilder_t b = {0};
+    jhandler_t h = {
+        jitapeobjbegin, jitapeobjend, jitapearrbegin, jitapearrend,
+        jitapekey, jitapestr, jitapeint, jitapenum, jitapebool, jitapenull, &b
+    };
+    jtape_t* tape = NULL;
+    if (!buf) return NULL;
+
+    if (!jsax_buffer(buf, len, &h) || !jitapeword(&b, 0)) goto cleanup;
+    if (!(tape = JC_MALLOC(sizeof *tape))) goto cleanup;
+    tape->words = (uint64_t*)(void*)b.words.ptr;
+    tape->count = b.words.len / sizeof(uint64_t) - 1;
+    tape->strings = b.strings.ptr;
+    tape->length = b.strings.len;
+    b.words.ptr = b.strings.ptr = NULL;
+
+cleanup:
+    JC_FREE(b.words.ptr);
+    JC_FREE(b.strings.ptr);
+    JC_FREE(b.stack.ptr);
+    return tape;
+}
+
+void jtape_free(jtape_t* tape) {
+    if (!tape) return;
+    JC_FREE(tape->words);
+    JC_FREE(tape->strings);
+    JC_FREE(tape);
+}
+
+static const jtnode_t jinotfound = {0};
+
+/* Tape ends with zero word, so stepping past root stops there */
+static int jitag(jtnode_t node) {
+    return node.tape ? JI_TAG(node.tape->words[node.at]) : 0;
+}
+
+/* Position right after value or entry at 'at' */
+static size_t jitapeskip(const jtape_t* tape, size_t at) {
+    switch (JI_TAG(tape->words[at])) {
+        case '[': case '{': return (tape->words[at] & UINT32_MAX) + 1;
+        case 'l': case 'd': return at + 2;
+        case 'k': return jitapeskip(tape, at + 1);
+        default: return at + 1;
+    }
+}
+
+jtnode_t jtroot(const jtape_t* tape) {
+    jtnode_t node = {0};
+    if (tape && tape->count) node.tape = tape;
+    return node;
+}
+
+bool jtfound(jtnode_t node) {
+    return node.tape != NULL;
+}
+
+jtype_t jttype(jtnode_t node) {
+    static const unsigned char types[128] = {
+        ['t'] = JT_BOOLEAN, ['f'] = JT_BOOLEAN,
+        ['l'] = JT_INTEGER, ['d'] = JT_NUMBER,
+        ['"'] = JT_STRING,  ['k'] = JT_STRING,
+        ['['] = JT_ARRAY,   ['{'] = JT_OBJECT,
+    };
+    return (jtype_t)types[jitag(node) & 127];
+}
+
+bool jtboolean(jtnode_t node) {
+    return jitag(node) == 't';
+}
+
+long long jtinteger(jtnode_t node) {
+    long long integer = 0;
+    int tag = jitag(node);
+    if (tag == 'l')
+        memcpy(&integer, &node.tape->words[node.at + 1], sizeof integer);
+    else if (tag == 'd')
+        integer = (long long)jtnumber(node);
+    return integer;
+}
+
+double jtnumber(jtnode_t node) {
+    double number = 0;
+    int tag = jitag(node);
+    if (tag == 'd')
+        memcpy(&number, &node.tape->words[node.at + 1], sizeof number);
+    else if (tag == 'l')
+        number = (double)jtinteger(node);
+    return number;
+}
+
+const char* jtstring(jtnode_t node) {
+    int tag = jitag(node);
+    if (tag != '"' && tag != 'k') return NULL;
+    return node.tape->strings + (node.tape->words[node.at] & (UINT64_MAX >> 8));
+}
+
+size_t jtcount(jtnode_t node) {
+    int tag = jitag(node);
+    if (tag != '[' && tag != '{') return 0;
+    size_t count = (node.tape->words[node.at] >> 32) & JI_COUNT_MAX;
+    if (count < JI_COUNT_MAX) return count;
+    for (node = jtfirst(node), count = 0; !jtend(node); node = jtnext(node)) count++;
+    return count;
+}
+
+jtnode_t jtfirst(jtnode_t node) {
+    int tag = jitag(node);
+    if (tag != '[' && tag != '{') return jinotfound;
+    node.at++;
+    return node;
+}
+
+jtnode_t jtnext(jtnode_t node) {
+    switch (jitag(node)) {
+        case 0: case ']': case '}': break;
+        case '[': case '{': node.at = (node.tape->words[node.at] & UINT32_MAX) + 1; break;
+        case 'l': case 'd': node.at += 2; break;
+        default: node.at = jitapeskip(node.tape, node.at);
+    }
+    return node;
+}
+
+bool jtend(jtnode_t node) {
+    int tag = jitag(node);
+    return !tag || tag == ']' || tag == '}';
+}
+
+const char* jtkey(jtnode_t entry) {
+    return jitag(entry) == 'k' ? jtstring(entry) : NULL;
+}
+
+jtnode_t jtvalue(jtnode_t entry) {
+    if (jitag(entry) != 'k') return jinotfound;
+    entry.at++;
+    return entry;
+}
+
+jtnode_t jtat(jtnode_t obj, const char* key) {
+    if (!key || jitag(obj) != '{') return jinotfound;
+    for (jtnode_t it = jtfirst(obj); !jtend(it); it = jtnext(it))
+        if (strcmp(jtstring(it), key) == 0) return jtvalue(it);
+    return jinotfound;
+}
+
+jtnode_t jtindex(jtnode_t arr, size_t index) {
+    if (jitag(arr) != '[') return jinotfound;
+    jtnode_t it = jtfirst(arr);
+    for (; !jtend(it) && index > 0; index--) it = jtnext(it);
+    return jtend(it) ? jinotfound : it;
+}
+
+jtnode_t (jtpath)(jtnode_t node, size_t depth, ...) {
+    va_list args;
+    va_start(args, depth);
+
+    while (node.tape && depth --> 0) {
+        /*  */ if (jitag(node) == '{')
+            node = jtat(node, va_arg(args, const char*));
+        else if (jitag(node) == '[')
+            node = jtindex(node, va_arg(args, size_t));
+        else
+            node = jinotfound;
+    }
+
+    va_end(args);
+    return node;
+}
+
+/* Output is gathered in 'sb' and handed to 'flush' in chunks,
+ * without 'flush' it just grows
+ */
+typedef struct jiwriter jiwriter_t;
+struct jiwriter {
+    jisb_t sb; bool ok, pretty;
+    bool (*flush)(jiwriter_t*);
+    void* dst;
+};
+
+static void jiput(jiwriter_t* w, const void* data, size_t size) {
+    if (!w->ok) return;
+    if (!jipushrun(data, size, &w->sb)) { w->ok = false; return; }
+    if (w->flush && w->sb.len >= JC_WRITE_CHUNK) {
+        w->ok = w->flush(w);
+        w->sb.len = 0;
+    }
+}
+
+static void jiputc(jiwriter_t* w, char ch) {
+    if (w->ok && w->sb.len < w->sb.cap && (!w->flush || w->sb.len + 1 < JC_WRITE_CHUNK))
+        w->sb.ptr[w->sb.len++] = ch;
+    else jiput(w, &ch, 1);
+}
+
+static void jiputindent(jiwriter_t* w, unsigned level) {
+    static const char spaces[] = "                                ";
+    size_t count = (size_t)level * JC_TAB_SIZE;
+    for (; count > sizeof spaces - 1; count -= sizeof spaces - 1)
+        jiput(w, spaces, sizeof spaces - 1);
+    jiput(w, spaces, count);
+}
+
+static void jiputstring(jiwriter_t* w, const char* str) {
+    static const char hex[] = "0123456789abcdef";
+    jiputc(w, '"');
+    while (*str) {
+        const char* run = str;
+        while ((unsigned char)*run >= ' ' && *run != '"' && *run != '\\') ++run;
+        if (run != str) { jiput(w, str, run - str); str = run; }
+        if (!*str) break;
+
+        char esc[6] = {'\\', 0};
+        switch (*str) {
+            case '"' : esc[1] =  '"'; break;
+            case '\\': esc[1] = '\\'; break;
+            case '\b': esc[1] =  'b'; break;
+            case '\f': esc[1] =  'f'; break;
+            case '\n': esc[1] =  'n'; break;
+            case '\r': esc[1] =  'r'; break;
+            case '\t': esc[1] =  't'; break;
+            default:
+                memcpy(esc + 1, "u00", 3);
+                esc[4] = hex[(unsigned char)*str >> 4];
+                esc[5] = hex[(unsigned char)*str & 15];
+                jiput(w, esc, 6); ++str;
+                continue;
+        }
+        jiput(w, esc, 2); ++str;
+    }
+    jiputc(w, '"');
+}
+
+static void jiputinteger(jiwriter_t* w, long long integer) {
+    char digits[24], *cur = digits + sizeof digits;
+    unsigned long long mag = integer < 0
+        ? 0ull - (unsigned long long)integer : (unsigned long long)integer;
+    do *--cur = '0' + mag % 10; while (mag /= 10);
+    if (integer < 0) *--cur = '-';
+    jiput(w, cur, digits + sizeof digits - cur);
+}
+
+/* Significands g of 10^e for e in [-292, 324] by Schubfach, that
+ * is floor(10^e * 2^(127 - floor(log2(10^e)))) + 1, high word first
+ */
+static const uint64_t jipow10sig[617][2] = {
+    { 0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7B }, { 0x9FAACF3DF73609B1, 0x77B191618C54E9AD },
+    { 0xC795830D75038C1D, 0xD59DF5B9EF6A2418 }, { 0xF97AE3D0D2446F25, 0x4B0573286B44AD1E },
+    { 0x9BECCE62836AC577, 0x4EE367F9430AEC33 }, { 0xC2E801FB244576D5, 0x229C41F793CDA740 },
+    { 0xF3A20279ED56D48A, 0x6B43527578C11110 }, { 0x9845418C345644D6, 0x830A13896B78AAAA },
+    { 0xBE5691EF416BD60C, 0x23CC986BC656D554 }, { 0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA9 },
+    { 0x94B3A202EB1C3F39, 0x7BF7D71432F3D6AA }, { 0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC54 },
+    { 0xE858AD248F5C22C9, 0xD1B3400F8F9CFF69 }, { 0x91376C36D99995BE, 0x23100809B9C21FA2 },
+    { 0xB58547448FFFFB2D, 0xABD40A0C2832A78B }, { 0xE2E69915B3FFF9F9, 0x16C90C8F323F516D },
+    { 0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E4 }, { 0xB1442798F49FFB4A, 0x99CD11CFDF41779D },
+    { 0xDD95317F31C7FA1D, 0x40405643D711D584 }, { 0x8A7D3EEF7F1CFC52, 0x482835EA666B2573 },
+    { 0xAD1C8EAB5EE43B66, 0xDA3243650005EED0 }, { 0xD863B256369D4A40, 0x90BED43E40076A83 },
+    { 0x873E4F75E2224E68, 0x5A7744A6E804A292 }, { 0xA90DE3535AAAE202, 0x711515D0A205CB37 },
+    { 0xD3515C2831559A83, 0x0D5A5B44CA873E04 }, { 0x8412D9991ED58091, 0xE858790AFE9486C3 },
+    { 0xA5178FFF668AE0B6, 0x626E974DBE39A873 }, { 0xCE5D73FF402D98E3, 0xFB0A3D212DC81290 },
+    { 0x80FA687F881C7F8E, 0x7CE66634BC9D0B9A }, { 0xA139029F6A239F72, 0x1C1FFFC1EBC44E81 },
+    { 0xC987434744AC874E, 0xA327FFB266B56221 }, { 0xFBE9141915D7A922, 0x4BF1FF9F0062BAA9 },
+    { 0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4AA }, { 0xC4CE17B399107C22, 0xCB550FB4384D21D4 },
+    { 0xF6019DA07F549B2B, 0x7E2A53A146606A49 }, { 0x99C102844F94E0FB, 0x2EDA7444CBFC426E },
+    { 0xC0314325637A1939, 0xFA911155FEFB5309 }, { 0xF03D93EEBC589F88, 0x793555AB7EBA27CB },
+    { 0x96267C7535B763B5, 0x4BC1558B2F3458DF }, { 0xBBB01B9283253CA2, 0x9EB1AAEDFB016F17 },
+    { 0xEA9C227723EE8BCB, 0x465E15A979C1CADD }, { 0x92A1958A7675175F, 0x0BFACD89EC191ECA },
+    { 0xB749FAED14125D36, 0xCEF980EC671F667C }, { 0xE51C79A85916F484, 0x82B7E12780E7401B },
+    { 0x8F31CC0937AE58D2, 0xD1B2ECB8B0908811 }, { 0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA16 },
+    { 0xDFBDCECE67006AC9, 0x67A791E093E1D49B }, { 0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E1 },
+    { 0xAECC49914078536D, 0x58FAE9F773886E19 }, { 0xDA7F5BF590966848, 0xAF39A475506A899F },
+    { 0x888F99797A5E012D, 0x6D8406C952429604 }, { 0xAAB37FD7D8F58178, 0xC8E5087BA6D33B84 },
+    { 0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A65 }, { 0x855C3BE0A17FCD26, 0x5CF2EEA09A550680 },
+    { 0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481F }, { 0xD0601D8EFC57B08B, 0xF13B94DAF124DA27 },
+    { 0x823C12795DB6CE57, 0x76C53D08D6B70859 }, { 0xA2CB1717B52481ED, 0x54768C4B0C64CA6F },
+    { 0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD0A }, { 0xFE5D54150B090B02, 0xD3F93B35435D7C4D },
+    { 0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DB0 }, { 0xC6B8E9B0709F109A, 0x359AB6419CA1091C },
+    { 0xF867241C8CC6D4C0, 0xC30163D203C94B63 }, { 0x9B407691D7FC44F8, 0x79E0DE63425DCF1E },
+    { 0xC21094364DFB5636, 0x985915FC12F542E5 }, { 0xF294B943E17A2BC4, 0x3E6F5B7B17B2939E },
+    { 0x979CF3CA6CEC5B5A, 0xA705992CEECF9C43 }, { 0xBD8430BD08277231, 0x50C6FF782A838354 },
+    { 0xECE53CEC4A314EBD, 0xA4F8BF5635246429 }, { 0x940F4613AE5ED136, 0x871B7795E136BE9A },
+    { 0xB913179899F68584, 0x28E2557B59846E40 }, { 0xE757DD7EC07426E5, 0x331AEADA2FE589D0 },
+    { 0x9096EA6F3848984F, 0x3FF0D2C85DEF7622 }, { 0xB4BCA50B065ABE63, 0x0FED077A756B53AA },
+    { 0xE1EBCE4DC7F16DFB, 0xD3E8495912C62895 }, { 0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95D },
+    { 0xB080392CC4349DEC, 0xBD8D794D96AACFB4 }, { 0xDCA04777F541C567, 0xECF0D7A0FC5583A1 },
+    { 0x89E42CAAF9491B60, 0xF41686C49DB57245 }, { 0xAC5D37D5B79B6239, 0x311C2875C522CED6 },
+    { 0xD77485CB25823AC7, 0x7D633293366B828C }, { 0x86A8D39EF77164BC, 0xAE5DFF9C02033198 },
+    { 0xA8530886B54DBDEB, 0xD9F57F830283FDFD }, { 0xD267CAA862A12D66, 0xD072DF63C324FD7C },
+    { 0x8380DEA93DA4BC60, 0x4247CB9E59F71E6E }, { 0xA46116538D0DEB78, 0x52D9BE85F074E609 },
+    { 0xCD795BE870516656, 0x67902E276C921F8C }, { 0x806BD9714632DFF6, 0x00BA1CD8A3DB53B7 },
+    { 0xA086CFCD97BF97F3, 0x80E8A40ECCD228A5 }, { 0xC8A883C0FDAF7DF0, 0x6122CD128006B2CE },
+    { 0xFAD2A4B13D1B5D6C, 0x796B805720085F82 }, { 0x9CC3A6EEC6311A63, 0xCBE3303674053BB1 },
+    { 0xC3F490AA77BD60FC, 0xBEDBFC4411068A9D }, { 0xF4F1B4D515ACB93B, 0xEE92FB5515482D45 },
+    { 0x991711052D8BF3C5, 0x751BDD152D4D1C4B }, { 0xBF5CD54678EEF0B6, 0xD262D45A78A0635E },
+    { 0xEF340A98172AACE4, 0x86FB897116C87C35 }, { 0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA1 },
+    { 0xBAE0A846D2195712, 0x8974836059CCA10A }, { 0xE998D258869FACD7, 0x2BD1A438703FC94C },
+    { 0x91FF83775423CC06, 0x7B6306A34627DDD0 }, { 0xB67F6455292CBF08, 0x1A3BC84C17B1D543 },
+    { 0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A94 }, { 0x8E938662882AF53E, 0x547EB47B7282EE9D },
+    { 0xB23867FB2A35B28D, 0xE99E619A4F23AA44 }, { 0xDEC681F9F4C31F31, 0x6405FA00E2EC94D5 },
+    { 0x8B3C113C38F9F37E, 0xDE83BC408DD3DD05 }, { 0xAE0B158B4738705E, 0x9624AB50B148D446 },
+    { 0xD98DDAEE19068C76, 0x3BADD624DD9B0958 }, { 0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D7 },
+    { 0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4D }, { 0xD47487CC8470652B, 0x7647C32000696720 },
+    { 0x84C8D4DFD2C63F3B, 0x29ECD9F40041E074 }, { 0xA5FB0A17C777CF09, 0xF468107100525891 },
+    { 0xCF79CC9DB955C2CC, 0x7182148D4066EEB5 }, { 0x81AC1FE293D599BF, 0xC6F14CD848405531 },
+    { 0xA21727DB38CB002F, 0xB8ADA00E5A506A7D }, { 0xCA9CF1D206FDC03B, 0xA6D90811F0E4851D },
+    { 0xFD442E4688BD304A, 0x908F4A166D1DA664 }, { 0x9E4A9CEC15763E2E, 0x9A598E4E043287FF },
+    { 0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FE }, { 0xF7549530E188C128, 0xD12BEE59E68EF47D },
+    { 0x9A94DD3E8CF578B9, 0x82BB74F8301958CF }, { 0xC13A148E3032D6E7, 0xE36A52363C1FAF02 },
+    { 0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC2 }, { 0x96F5600F15A7B7E5, 0x29AB103A5EF8C0BA },
+    { 0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E8 }, { 0xEBDF661791D60F56, 0x111B495B3464AD22 },
+    { 0x936B9FCEBB25C995, 0xCAB10DD900BEEC35 }, { 0xB84687C269EF3BFB, 0x3D5D514F40EEA743 },
+    { 0xE65829B3046B0AFA, 0x0CB4A5A3112A5113 }, { 0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AC },
+    { 0xB3F4E093DB73A093, 0x59ED216765690F57 }, { 0xE0F218B8D25088B8, 0x306869C13EC3532D },
+    { 0x8C974F7383725573, 0x1E414218C73A13FC }, { 0xAFBD2350644EEACF, 0xE5D1929EF90898FB },
+    { 0xDBAC6C247D62A583, 0xDF45F746B74ABF3A }, { 0x894BC396CE5DA772, 0x6B8BBA8C328EB784 },
+    { 0xAB9EB47C81F5114F, 0x066EA92F3F326565 }, { 0xD686619BA27255A2, 0xC80A537B0EFEFEBE },
+    { 0x8613FD0145877585, 0xBD06742CE95F5F37 }, { 0xA798FC4196E952E7, 0x2C48113823B73705 },
+    { 0xD17F3B51FCA3A7A0, 0xF75A15862CA504C6 }, { 0x82EF85133DE648C4, 0x9A984D73DBE722FC },
+    { 0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBB }, { 0xCC963FEE10B7D1B3, 0x318DF905079926A9 },
+    { 0xFFBBCFE994E5C61F, 0xFDF17746497F7053 }, { 0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA634 },
+    { 0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC1 }, { 0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B1 },
+    { 0x9C1661A651213E2D, 0x06BEA10CA65C084F }, { 0xC31BFA0FE5698DB8, 0x486E494FCFF30A63 },
+    { 0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFB }, { 0x986DDB5C6B3A76B7, 0xF89629465A75E01D },
+    { 0xBE89523386091465, 0xF6BBB397F1135824 }, { 0xEE2BA6C0678B597F, 0x746AA07DED582E2D },
+    { 0x94DB483840B717EF, 0xA8C2A44EB4571CDD }, { 0xBA121A4650E4DDEB, 0x92F34D62616CE414 },
+    { 0xE896A0D7E51E1566, 0x77B020BAF9C81D18 }, { 0x915E2486EF32CD60, 0x0ACE1474DC1D122F },
+    { 0xB5B5ADA8AAFF80B8, 0x0D819992132456BB }, { 0xE3231912D5BF60E6, 0x10E1FFF697ED6C6A },
+    { 0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C2 }, { 0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB3 },
+    { 0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDF }, { 0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96C },
+    { 0xAD4AB7112EB3929D, 0x86C16C98D2C953C7 }, { 0xD89D64D57A607744, 0xE871C7BF077BA8B8 },
+    { 0x87625F056C7C4A8B, 0x11471CD764AD4973 }, { 0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BD0 },
+    { 0xD389B47879823479, 0x4AFF1D108D4EC2C4 }, { 0x843610CB4BF160CB, 0xCEDF722A585139BB },
+    { 0xA54394FE1EEDB8FE, 0xC2974EB4EE658829 }, { 0xCE947A3DA6A9273E, 0x733D226229FEEA33 },
+    { 0x811CCC668829B887, 0x0806357D5A3F5260 }, { 0xA163FF802A3426A8, 0xCA07C2DCB0CF26F8 },
+    { 0xC9BCFF6034C13052, 0xFC89B393DD02F0B6 }, { 0xFC2C3F3841F17C67, 0xBBAC2078D443ACE3 },
+    { 0x9D9BA7832936EDC0, 0xD54B944B84AA4C0E }, { 0xC5029163F384A931, 0x0A9E795E65D4DF12 },
+    { 0xF64335BCF065D37D, 0x4D4617B5FF4A16D6 }, { 0x99EA0196163FA42E, 0x504BCED1BF8E4E46 },
+    { 0xC06481FB9BCF8D39, 0xE45EC2862F71E1D7 }, { 0xF07DA27A82C37088, 0x5D767327BB4E5A4D },
+    { 0x964E858C91BA2655, 0x3A6A07F8D510F870 }, { 0xBBE226EFB628AFEA, 0x890489F70A55368C },
+    { 0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842F }, { 0x92C8AE6B464FC96F, 0x3B0B8BC90012929E },
+    { 0xB77ADA0617E3BBCB, 0x09CE6EBB40173745 }, { 0xE55990879DDCAABD, 0xCC420A6A101D0516 },
+    { 0x8F57FA54C2A9EAB6, 0x9FA946824A12232E }, { 0xB32DF8E9F3546564, 0x47939822DC96ABFA },
+    { 0xDFF9772470297EBD, 0x59787E2B93BC56F8 }, { 0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65B },
+    { 0xAEFAE51477A06B03, 0xEDE622920B6B23F2 }, { 0xDAB99E59958885C4, 0xE95FAB368E45ECEE },
+    { 0x88B402F7FD75539B, 0x11DBCB0218EBB415 }, { 0xAAE103B5FCD2A881, 0xD652BDC29F26A11A },
+    { 0xD59944A37C0752A2, 0x4BE76D3346F04960 }, { 0x857FCAE62D8493A5, 0x6F70A4400C562DDC },
+    { 0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB953 }, { 0xD097AD07A71F26B2, 0x7E2000A41346A7A8 },
+    { 0x825ECC24C873782F, 0x8ED400668C0C28C9 }, { 0xA2F67F2DFA90563B, 0x728900802F0F32FB },
+    { 0xCBB41EF979346BCA, 0x4F2B40A03AD2FFBA }, { 0xFEA126B7D78186BC, 0xE2F610C84987BFA9 },
+    { 0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7CA }, { 0xC6EDE63FA05D3143, 0x91503D1C79720DBC },
+    { 0xF8A95FCF88747D94, 0x75A44C6397CE912B }, { 0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABB },
+    { 0xC24452DA229B021B, 0xFBE85BADCE996169 }, { 0xF2D56790AB41C2A2, 0xFAE27299423FB9C4 },
+    { 0x97C560BA6B0919A5, 0xDCCD879FC967D41B }, { 0xBDB6B8E905CB600F, 0x5400E987BBC1C921 },
+    { 0xED246723473E3813, 0x290123E9AAB23B69 }, { 0x9436C0760C86E30B, 0xF9A0B6720AAF6522 },
+    { 0xB94470938FA89BCE, 0xF808E40E8D5B3E6A }, { 0xE7958CB87392C2C2, 0xB60B1D1230B20E05 },
+    { 0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C3 }, { 0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF4 },
+    { 0xE2280B6C20DD5232, 0x25C6DA63C38DE1B1 }, { 0x8D590723948A535F, 0x579C487E5A38AD0F },
+    { 0xB0AF48EC79ACE837, 0x2D835A9DF0C6D852 }, { 0xDCDB1B2798182244, 0xF8E431456CF88E66 },
+    { 0x8A08F0F8BF0F156B, 0x1B8E9ECB641B5900 }, { 0xAC8B2D36EED2DAC5, 0xE272467E3D222F40 },
+    { 0xD7ADF884AA879177, 0x5B0ED81DCC6ABB10 }, { 0x86CCBB52EA94BAEA, 0x98E947129FC2B4EA },
+    { 0xA87FEA27A539E9A5, 0x3F2398D747B36225 }, { 0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAE },
+    { 0x83A3EEEEF9153E89, 0x1953CF68300424AD }, { 0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD8 },
+    { 0xCDB02555653131B6, 0x3792F412CB06794E }, { 0x808E17555F3EBF11, 0xE2BBD88BBEE40BD1 },
+    { 0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC5 }, { 0xC8DE047564D20A8B, 0xF245825A5A445276 },
+    { 0xFB158592BE068D2E, 0xEED6E2F0F0D56713 }, { 0x9CED737BB6C4183D, 0x55464DD69685606C },
+    { 0xC428D05AA4751E4C, 0xAA97E14C3C26B887 }, { 0xF53304714D9265DF, 0xD53DD99F4B3066A9 },
+    { 0x993FE2C6D07B7FAB, 0xE546A8038EFE402A }, { 0xBF8FDB78849A5F96, 0xDE98520472BDD034 },
+    { 0xEF73D256A5C0F77C, 0x963E66858F6D4441 }, { 0x95A8637627989AAD, 0xDDE7001379A44AA9 },
+    { 0xBB127C53B17EC159, 0x5560C018580D5D53 }, { 0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A7 },
+    { 0x9226712162AB070D, 0xCAB3961304CA70E9 }, { 0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D23 },
+    { 0xE45C10C42A2B3B05, 0x8CB89A7DB77C506B }, { 0x8EB98A7A9A5B04E3, 0x77F3608E92ADB243 },
+    { 0xB267ED1940F1C61C, 0x55F038B237591ED4 }, { 0xDF01E85F912E37A3, 0x6B6C46DEC52F6689 },
+    { 0x8B61313BBABCE2C6, 0x2323AC4B3B3DA016 }, { 0xAE397D8AA96C1B77, 0xABEC975E0A0D081B },
+    { 0xD9C7DCED53C72255, 0x96E7BD358C904A22 }, { 0x881CEA14545C7575, 0x7E50D64177DA2E55 },
+    { 0xAA242499697392D2, 0xDDE50BD1D5D0B9EA }, { 0xD4AD2DBFC3D07787, 0x955E4EC64B44E865 },
+    { 0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113F }, { 0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58F },
+    { 0xCFB11EAD453994BA, 0x67DE18EDA5814AF3 }, { 0x81CEB32C4B43FCF4, 0x80EACF948770CED8 },
+    { 0xA2425FF75E14FC31, 0xA1258379A94D028E }, { 0xCAD2F7F5359A3B3E, 0x096EE45813A04331 },
+    { 0xFD87B5F28300CA0D, 0x8BCA9D6E188853FD }, { 0x9E74D1B791E07E48, 0x775EA264CF55347E },
+    { 0xC612062576589DDA, 0x95364AFE032A819E }, { 0xF79687AED3EEC551, 0x3A83DDBD83F52205 },
+    { 0x9ABE14CD44753B52, 0xC4926A9672793543 }, { 0xC16D9A0095928A27, 0x75B7053C0F178294 },
+    { 0xF1C90080BAF72CB1, 0x5324C68B12DD6339 }, { 0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04 },
+    { 0xBCE5086492111AEA, 0x88F4BB1CA6BCF585 }, { 0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6 },
+    { 0x9392EE8E921D5D07, 0x3AFF322E62439FD0 }, { 0xB877AA3236A4B449, 0x09BEFEB9FAD487C3 },
+    { 0xE69594BEC44DE15B, 0x4C2EBE687989A9B4 }, { 0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11 },
+    { 0xB424DC35095CD80F, 0x538484C19EF38C95 }, { 0xE12E13424BB40E13, 0x2865A5F206B06FBA },
+    { 0x8CBCCC096F5088CB, 0xF93F87B7442E45D4 }, { 0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749 },
+    { 0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C }, { 0x89705F4136B4A597, 0x31680A88F8953031 },
+    { 0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E }, { 0xD6BF94D5E57A42BC, 0x3D32907604691B4D },
+    { 0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110 }, { 0xA7C5AC471B478423, 0x0FCF80DC33721D54 },
+    { 0xD1B71758E219652B, 0xD3C36113404EA4A9 }, { 0x83126E978D4FDF3B, 0x645A1CAC083126EA },
+    { 0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4 }, { 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD },
+    { 0x8000000000000000, 0x0000000000000001 }, { 0xA000000000000000, 0x0000000000000001 },
+    { 0xC800000000000000, 0x0000000000000001 }, { 0xFA00000000000000, 0x0000000000000001 },
+    { 0x9C40000000000000, 0x0000000000000001 }, { 0xC350000000000000, 0x0000000000000001 },
+    { 0xF424000000000000, 0x0000000000000001 }, { 0x9896800000000000, 0x0000000000000001 },
+    { 0xBEBC200000000000, 0x0000000000000001 }, { 0xEE6B280000000000, 0x0000000000000001 },
+    { 0x9502F90000000000, 0x0000000000000001 }, { 0xBA43B74000000000, 0x0000000000000001 },
+    { 0xE8D4A51000000000, 0x0000000000000001 }, { 0x9184E72A00000000, 0x0000000000000001 },
+    { 0xB5E620F480000000, 0x0000000000000001 }, { 0xE35FA931A0000000, 0x0000000000000001 },
+    { 0x8E1BC9BF04000000, 0x0000000000000001 }, { 0xB1A2BC2EC5000000, 0x0000000000000001 },
+    { 0xDE0B6B3A76400000, 0x0000000000000001 }, { 0x8AC7230489E80000, 0x0000000000000001 },
+    { 0xAD78EBC5AC620000, 0x0000000000000001 }, { 0xD8D726B7177A8000, 0x0000000000000001 },
+    { 0x878678326EAC9000, 0x0000000000000001 }, { 0xA968163F0A57B400, 0x0000000000000001 },
+    { 0xD3C21BCECCEDA100, 0x0000000000000001 }, { 0x84595161401484A0, 0x0000000000000001 },
+    { 0xA56FA5B99019A5C8, 0x0000000000000001 }, { 0xCECB8F27F4200F3A, 0x0000000000000001 },
+    { 0x813F3978F8940984, 0x4000000000000001 }, { 0xA18F07D736B90BE5, 0x5000000000000001 },
+    { 0xC9F2C9CD04674EDE, 0xA400000000000001 }, { 0xFC6F7C4045812296, 0x4D00000000000001 },
+    { 0x9DC5ADA82B70B59D, 0xF020000000000001 }, { 0xC5371912364CE305, 0x6C28000000000001 },
+    { 0xF684DF56C3E01BC6, 0xC732000000000001 }, { 0x9A130B963A6C115C, 0x3C7F400000000001 },
+    { 0xC097CE7BC90715B3, 0x4B9F100000000001 }, { 0xF0BDC21ABB48DB20, 0x1E86D40000000001 },
+    { 0x96769950B50D88F4, 0x1314448000000001 }, { 0xBC143FA4E250EB31, 0x17D955A000000001 },
+    { 0xEB194F8E1AE525FD, 0x5DCFAB0800000001 }, { 0x92EFD1B8D0CF37BE, 0x5AA1CAE500000001 },
+    { 0xB7ABC627050305AD, 0xF14A3D9E40000001 }, { 0xE596B7B0C643C719, 0x6D9CCD05D0000001 },
+    { 0x8F7E32CE7BEA5C6F, 0xE4820023A2000001 }, { 0xB35DBF821AE4F38B, 0xDDA2802C8A800001 },
+    { 0xE0352F62A19E306E, 0xD50B2037AD200001 }, { 0x8C213D9DA502DE45, 0x4526F422CC340001 },
+    { 0xAF298D050E4395D6, 0x9670B12B7F410001 }, { 0xDAF3F04651D47B4C, 0x3C0CDD765F114001 },
+    { 0x88D8762BF324CD0F, 0xA5880A69FB6AC801 }, { 0xAB0E93B6EFEE0053, 0x8EEA0D047A457A01 },
+    { 0xD5D238A4ABE98068, 0x72A4904598D6D881 }, { 0x85A36366EB71F041, 0x47A6DA2B7F864751 },
+    { 0xA70C3C40A64E6C51, 0x999090B65F67D925 }, { 0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6E },
+    { 0x82818F1281ED449F, 0xBFF8F10E7A8921A5 }, { 0xA321F2D7226895C7, 0xAFF72D52192B6A0E },
+    { 0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764491 }, { 0xFEE50B7025C36A08, 0x02F236D04753D5B5 },
+    { 0x9F4F2726179A2245, 0x01D762422C946591 }, { 0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF6 },
+    { 0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB3 }, { 0x9B934C3B330C8577, 0x63CC55F49F88EB30 },
+    { 0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FC }, { 0xF316271C7FC3908A, 0x8BEF464E3945EF7B },
+    { 0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AD }, { 0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA318 },
+    { 0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDE }, { 0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6B },
+    { 0xB975D6B6EE39E436, 0xB3E2FD538E122B45 }, { 0xE7D34C64A9C85D44, 0x60DBBCA87196B617 },
+    { 0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CE }, { 0xB51D13AEA4A488DD, 0x6BABAB6398BDBE42 },
+    { 0xE264589A4DCDAB14, 0xC696963C7EED2DD2 }, { 0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA3 },
+    { 0xB0DE65388CC8ADA8, 0x3B25A55F43294BCC }, { 0xDD15FE86AFFAD912, 0x49EF0EB713F39EBF },
+    { 0x8A2DBF142DFCC7AB, 0x6E3569326C784338 }, { 0xACB92ED9397BF996, 0x49C2C37F07965405 },
+    { 0xD7E77A8F87DAF7FB, 0xDC33745EC97BE907 }, { 0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A4 },
+    { 0xA8ACD7C0222311BC, 0xC40832EA0D68CE0D }, { 0xD2D80DB02AABD62B, 0xF50A3FA490C30191 },
+    { 0x83C7088E1AAB65DB, 0x792667C6DA79E0FB }, { 0xA4B8CAB1A1563F52, 0x577001B891185939 },
+    { 0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F87 }, { 0x80B05E5AC60B6178, 0x544F8158315B05B5 },
+    { 0xA0DC75F1778E39D6, 0x696361AE3DB1C722 }, { 0xC913936DD571C84C, 0x03BC3A19CD1E38EA },
+    { 0xFB5878494ACE3A5F, 0x04AB48A04065C724 }, { 0x9D174B2DCEC0E47B, 0x62EB0D64283F9C77 },
+    { 0xC45D1DF942711D9A, 0x3BA5D0BD324F8395 }, { 0xF5746577930D6500, 0xCA8F44EC7EE3647A },
+    { 0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECC }, { 0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67F },
+    { 0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101F }, { 0x95D04AEE3B80ECE5, 0xBBA1F1D158724A13 },
+    { 0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC98 }, { 0xEA1575143CF97226, 0xF52D09D71A3293BE },
+    { 0x924D692CA61BE758, 0x593C2626705F9C57 }, { 0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836D },
+    { 0xE498F455C38B997A, 0x0B6DFB9C0F956448 }, { 0x8EDF98B59A373FEC, 0x4724BD4189BD5EAD },
+    { 0xB2977EE300C50FE7, 0x58EDEC91EC2CB658 }, { 0xDF3D5E9BC0F653E1, 0x2F2967B66737E3EE },
+    { 0x8B865B215899F46C, 0xBD79E0D20082EE75 }, { 0xAE67F1E9AEC07187, 0xECD8590680A3AA12 },
+    { 0xDA01EE641A708DE9, 0xE80E6F4820CC9496 }, { 0x884134FE908658B2, 0x3109058D147FDCDE },
+    { 0xAA51823E34A7EEDE, 0xBD4B46F0599FD416 }, { 0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91B },
+    { 0x850FADC09923329E, 0x03E2CF6BC604DDB1 }, { 0xA6539930BF6BFF45, 0x84DB8346B786151D },
+    { 0xCFE87F7CEF46FF16, 0xE612641865679A64 }, { 0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07F },
+    { 0xA26DA3999AEF7749, 0xE3BE5E330F38F09E }, { 0xCB090C8001AB551C, 0x5CADF5BFD3072CC6 },
+    { 0xFDCB4FA002162A63, 0x73D9732FC7C8F7F7 }, { 0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFB },
+    { 0xC646D63501A1511D, 0xB281E1FD541501B9 }, { 0xF7D88BC24209A565, 0x1F225A7CA91A4227 },
+    { 0x9AE757596946075F, 0x3375788DE9B06959 }, { 0xC1A12D2FC3978937, 0x0052D6B1641C83AF },
+    { 0xF209787BB47D6B84, 0xC0678C5DBD23A49B }, { 0x9745EB4D50CE6332, 0xF840B7BA963646E1 },
+    { 0xBD176620A501FBFF, 0xB650E5A93BC3D899 }, { 0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBF },
+    { 0x93BA47C980E98CDF, 0xC66F336C36B10138 }, { 0xB8A8D9BBE123F017, 0xB80B0047445D4185 },
+    { 0xE6D3102AD96CEC1D, 0xA60DC059157491E6 }, { 0x9043EA1AC7E41392, 0x87C89837AD68DB30 },
+    { 0xB454E4A179DD1877, 0x29BABE4598C311FC }, { 0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67B },
+    { 0x8CE2529E2734BB1D, 0x1899E4A65F58660D }, { 0xB01AE745B101E9E4, 0x5EC05DCFF72E7F90 },
+    { 0xDC21A1171D42645D, 0x76707543F4FA1F74 }, { 0x899504AE72497EBA, 0x6A06494A791C53A9 },
+    { 0xABFA45DA0EDBDE69, 0x0487DB9D17636893 }, { 0xD6F8D7509292D603, 0x45A9D2845D3C42B7 },
+    { 0x865B86925B9BC5C2, 0x0B8A2392BA45A9B3 }, { 0xA7F26836F282B732, 0x8E6CAC7768D7141F },
+    { 0xD1EF0244AF2364FF, 0x3207D795430CD927 }, { 0x8335616AED761F1F, 0x7F44E6BD49E807B9 },
+    { 0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A7 }, { 0xCD036837130890A1, 0x36DBA887C37A8C10 },
+    { 0x802221226BE55A64, 0xC2494954DA2C978A }, { 0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6D },
+    { 0xC83553C5C8965D3D, 0x6F92829494E5ACC8 }, { 0xFA42A8B73ABBF48C, 0xCB772339BA1F17FA },
+    { 0x9C69A97284B578D7, 0xFF2A760414536EFC }, { 0xC38413CF25E2D70D, 0xFEF5138519684ABB },
+    { 0xF46518C2EF5B8CD1, 0x7EB258665FC25D6A }, { 0x98BF2F79D5993802, 0xEF2F773FFBD97A62 },
+    { 0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FB }, { 0xEEAABA2E5DBF6784, 0x95BA2A53F983CF39 },
+    { 0x952AB45CFA97A0B2, 0xDD945A747BF26184 }, { 0xBA756174393D88DF, 0x94F971119AEEF9E5 },
+    { 0xE912B9D1478CEB17, 0x7A37CD5601AAB85E }, { 0x91ABB422CCB812EE, 0xAC62E055C10AB33B },
+    { 0xB616A12B7FE617AA, 0x577B986B314D600A }, { 0xE39C49765FDF9D94, 0xED5A7E85FDA0B80C },
+    { 0x8E41ADE9FBEBC27D, 0x14588F13BE847308 }, { 0xB1D219647AE6B31C, 0x596EB2D8AE258FC9 },
+    { 0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BC }, { 0x8AEC23D680043BEE, 0x25DE7BB9480D5855 },
+    { 0xADA72CCC20054AE9, 0xAF561AA79A10AE6B }, { 0xD910F7FF28069DA4, 0x1B2BA1518094DA05 },
+    { 0x87AA9AFF79042286, 0x90FB44D2F05D0843 }, { 0xA99541BF57452B28, 0x353A1607AC744A54 },
+    { 0xD3FA922F2D1675F2, 0x42889B8997915CE9 }, { 0x847C9B5D7C2E09B7, 0x69956135FEBADA12 },
+    { 0xA59BC234DB398C25, 0x43FAB9837E699096 }, { 0xCF02B2C21207EF2E, 0x94F967E45E03F4BC },
+    { 0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F6 }, { 0xA1BA1BA79E1632DC, 0x6462D92A69731733 },
+    { 0xCA28A291859BBF93, 0x7D7B8F7503CFDCFF }, { 0xFCB2CB35E702AF78, 0x5CDA735244C3D43F },
+    { 0x9DEFBF01B061ADAB, 0x3A0888136AFA64A8 }, { 0xC56BAEC21C7A1916, 0x088AAA1845B8FDD1 },
+    { 0xF6C69A72A3989F5B, 0x8AAD549E57273D46 }, { 0x9A3C2087A63F6399, 0x36AC54E2F678864C },
+    { 0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DE }, { 0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D6 },
+    { 0x969EB7C47859E743, 0x9F644AE5A4B1B326 }, { 0xBC4665B596706114, 0x873D5D9F0DDE1FEF },
+    { 0xEB57FF22FC0C7959, 0xA90CB506D155A7EB }, { 0x9316FF75DD87CBD8, 0x09A7F12442D588F3 },
+    { 0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB30 }, { 0xE5D3EF282A242E81, 0x8F1668C8A86DA5FB },
+    { 0x8FA475791A569D10, 0xF96E017D694487BD }, { 0xB38D92D760EC4455, 0x37C981DCC395A9AD },
+    { 0xE070F78D3927556A, 0x85BBE253F47B1418 }, { 0x8C469AB843B89562, 0x93956D7478CCEC8F },
+    { 0xAF58416654A6BABB, 0x387AC8D1970027B3 }, { 0xDB2E51BFE9D0696A, 0x06997B05FCC0319F },
+    { 0x88FCF317F22241E2, 0x441FECE3BDF81F04 }, { 0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C4 },
+    { 0xD60B3BD56A5586F1, 0x8A71E223D8D3B075 }, { 0x85C7056562757456, 0xF6872D5667844E4A },
+    { 0xA738C6BEBB12D16C, 0xB428F8AC016561DC }, { 0xD106F86E69D785C7, 0xE13336D701BEBA53 },
+    { 0x82A45B450226B39C, 0xECC0024661173474 }, { 0xA34D721642B06084, 0x27F002D7F95D0191 },
+    { 0xCC20CE9BD35C78A5, 0x31EC038DF7B441F5 }, { 0xFF290242C83396CE, 0x7E67047175A15272 },
+    { 0x9F79A169BD203E41, 0x0F0062C6E984D387 }, { 0xC75809C42C684DD1, 0x52C07B78A3E60869 },
+    { 0xF92E0C3537826145, 0xA7709A56CCDF8A83 }, { 0x9BBCC7A142B17CCB, 0x88A66076400BB692 },
+    { 0xC2ABF989935DDBFE, 0x6ACFF893D00EA436 }, { 0xF356F7EBF83552FE, 0x0583F6B8C4124D44 },
+    { 0x98165AF37B2153DE, 0xC3727A337A8B704B }, { 0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5D },
+    { 0xEDA2EE1C7064130C, 0x1162DEF06F79DF74 }, { 0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA9 },
+    { 0xB9A74A0637CE2EE1, 0x6D953E2BD7173693 }, { 0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0438 },
+    { 0x910AB1D4DB9914A0, 0x1D9C9892400A22A3 }, { 0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4C },
+    { 0xE2A0B5DC971F303A, 0x2E44AE64840FD61E }, { 0x8DA471A9DE737E24, 0x5CEAECFED289E5D3 },
+    { 0xB10D8E1456105DAD, 0x7425A83E872C5F48 }, { 0xDD50F1996B947518, 0xD12F124E28F7771A },
+    { 0x8A5296FFE33CC92F, 0x82BD6B70D99AAA70 }, { 0xACE73CBFDC0BFB7B, 0x636CC64D1001550C },
+    { 0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4F }, { 0x8714A775E3E95C78, 0x65ACFAEC34810A72 },
+    { 0xA8D9D1535CE3B396, 0x7F1839A741A14D0E }, { 0xD31045A8341CA07C, 0x1EDE48111209A051 },
+    { 0x83EA2B892091E44D, 0x934AED0AAB460433 }, { 0xA4E4B66B68B65D60, 0xF81DA84D56178540 },
+    { 0xCE1DE40642E3F4B9, 0x36251260AB9D668F }, { 0x80D2AE83E9CE78F3, 0xC1D72B7C6B42601A },
+    { 0xA1075A24E4421730, 0xB24CF65B8612F820 }, { 0xC94930AE1D529CFC, 0xDEE033F26797B628 },
+    { 0xFB9B7CD9A4A7443C, 0x169840EF017DA3B2 }, { 0x9D412E0806E88AA5, 0x8E1F289560EE864F },
+    { 0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E3 }, { 0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DC },
+    { 0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF2A }, { 0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF4 },
+    { 0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B1 }, { 0x95F83D0A1FB69CD9, 0x4ABDAF101564F98F },
+    { 0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F2 }, { 0xEA53DF5FD18D5513, 0x84C86189216DC5EE },
+    { 0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB5 }, { 0xB7118682DBB66A77, 0x3FBC8C33221DC2A2 },
+    { 0xE4D5E82392A40515, 0x0FABAF3FEAA5334B }, { 0x8F05B1163BA6832D, 0x29CB4D87F2A7400F },
+    { 0xB2C71D5BCA9023F8, 0x743E20E9EF511013 }, { 0xDF78E4B2BD342CF6, 0x914DA9246B255417 },
+    { 0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548F }, { 0xAE9672ABA3D0C320, 0xA184AC2473B529B2 },
+    { 0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741F }, { 0x8865899617FB1871, 0x7E2FA67C7A658893 },
+    { 0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB8 }, { 0xD51EA6FA85785631, 0x552A74227F3EA566 },
+    { 0x8533285C936B35DE, 0xD53A88958F872760 }, { 0xA67FF273B8460356, 0x8A892ABAF368F138 },
+    { 0xD01FEF10A657842C, 0x2D2B7569B0432D86 }, { 0x8213F56A67F6B29B, 0x9C3B29620E29FC74 },
+    { 0xA298F2C501F45F42, 0x8349F3BA91B47B90 }, { 0xCB3F2F7642717713, 0x241C70A936219A74 },
+    { 0xFE0EFB53D30DD4D7, 0xED238CD383AA0111 }, { 0x9EC95D1463E8A506, 0xF4363804324A40AB },
+    { 0xC67BB4597CE2CE48, 0xB143C6053EDCD0D6 }, { 0xF81AA16FDC1B81DA, 0xDD94B7868E94050B },
+    { 0x9B10A4E5E9913128, 0xCA7CF2B4191C8327 }, { 0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F1 },
+    { 0xF24A01A73CF2DCCF, 0xBC633B39673C8CED }, { 0x976E41088617CA01, 0xD5BE0503E085D814 },
+    { 0xBD49D14AA79DBC82, 0x4B2D8644D8A74E19 }, { 0xEC9C459D51852BA2, 0xDDF8E7D60ED1219F },
+    { 0x93E1AB8252F33B45, 0xCABB90E5C942B504 }, { 0xB8DA1662E7B00A17, 0x3D6A751F3B936244 },
+    { 0xE7109BFBA19C0C9D, 0x0CC512670A783AD5 }, { 0x906A617D450187E2, 0x27FB2B80668B24C6 },
+    { 0xB484F9DC9641E9DA, 0xB1F9F660802DEDF7 }, { 0xE1A63853BBD26451, 0x5E7873F8A0396974 },
+    { 0x8D07E33455637EB2, 0xDB0B487B6423E1E9 }, { 0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA63 },
+    { 0xDC5C5301C56B75F7, 0x7641A140CC7810FC }, { 0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9E },
+    { 0xAC2820D9623BF429, 0x546345FA9FBDCD45 }, { 0xD732290FBACAF133, 0xA97C177947AD4096 },
+    { 0x867F59A9D4BED6C0, 0x49ED8EABCCCC485E }, { 0xA81F301449EE8C70, 0x5C68F256BFFF5A75 },
+    { 0xD226FC195C6A2F8C, 0x73832EEC6FFF3112 }, { 0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAC },
+    { 0xA42E74F3D032F525, 0xBA3E7CA8B77F5E56 }, { 0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EC },
+    { 0x80444B5E7AA7CF85, 0x7980D163CF5B81B4 }, { 0xA0555E361951C366, 0xD7E105BCC3326220 },
+    { 0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA8 }, { 0xFA856334878FC150, 0xB14F98F6F0FEB952 },
+    { 0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D4 }, { 0xC3B8358109E84F07, 0x0A862F80EC4700C9 },
+    { 0xF4A642E14C6262C8, 0xCD27BB612758C0FB }, { 0x98E7E9CCCFBD7DBD, 0x8038D51CB897789D },
+    { 0xBF21E44003ACDD2C, 0xE0470A63E6BD56C4 }, { 0xEEEA5D5004981478, 0x1858CCFCE06CAC75 },
+    { 0x95527A5202DF0CCB, 0x0F37801E0C43EBC9 }, { 0xBAA718E68396CFFD, 0xD30560258F54E6BB },
+    { 0xE950DF20247C83FD, 0x47C6B82EF32A206A }, { 0x91D28B7416CDD27E, 0x4CDC331D57FA5442 },
+    { 0xB6472E511C81471D, 0xE0133FE4ADF8E953 }, { 0xE3D8F9E563A198E5, 0x58180FDDD97723A7 },
+    { 0x8E679C2F5E44FF8F, 0x570F09EAA7EA7649 }, { 0xB201833B35D63F73, 0x2CD2CC6551E513DB },
+    { 0xDE81E40A034BCF4F, 0xF8077F7EA65E58D2 }, { 0x8B112E86420F6191, 0xFB04AFAF27FAF783 },
+    { 0xADD57A27D29339F6, 0x79C5DB9AF1F9B564 }, { 0xD94AD8B1C7380874, 0x18375281AE7822BD },
+    { 0x87CEC76F1C830548, 0x8F2293910D0B15B6 }, { 0xA9C2794AE3A3C69A, 0xB2EB3875504DDB23 },
+    { 0xD433179D9C8CB841, 0x5FA60692A46151EC }, { 0x849FEEC281D7F328, 0xDBC7C41BA6BCD334 },
+    { 0xA5C7EA73224DEFF3, 0x12B9B522906C0801 }, { 0xCF39E50FEAE16BEF, 0xD768226B34870A01 },
+    { 0x81842F29F2CCE375, 0xE6A1158300D46641 }, { 0xA1E53AF46F801C53, 0x60495AE3C1097FD1 },
+    { 0xCA5E89B18B602368, 0x385BB19CB14BDFC5 }, { 0xFCF62C1DEE382C42, 0x46729E03DD9ED7B6 },
+    { 0x9E19DB92B4E31BA9, 0x6C07A2C26A8346D2 },
+};
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 jiuint128_t;
+
+static uint64_t jimulhi(uint64_t a, uint64_t b, uint64_t* lo) {
+    jiuint128_t product = (jiuint128_t)a * b;
+    *lo = (uint64_t)product;
+    return (uint64_t)(product >> 64);
+}
+#else
+static uint64_t jimulhi(uint64_t a, uint64_t b, uint64_t* lo) {
+    uint64_t al = a & 0xFFFFFFFF, ah = a >> 32;
+    uint64_t bl = b & 0xFFFFFFFF, bh = b >> 32;
+    uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    *lo = (mid << 32) | (ll & 0xFFFFFFFF);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+#endif
+
+/* Top word of g * cp / 2^128 rounded to odd */
+static uint64_t jiroundodd(const uint64_t* g, uint64_t cp) {
+    uint64_t xlo, ylo;
+    uint64_t xhi = jimulhi(g[1], cp, &xlo);
+    uint64_t yhi = jimulhi(g[0], cp, &ylo);
+    uint64_t mid = ylo + xhi;
+    (void)xlo;
+    return (yhi + (mid < ylo)) | (mid > 1);
+}
+
+static int jifloorshift(long long value, int shift) {
+    return (int)(value >= 0 ? value >> shift : ~(~value >> shift));
+}
+
+/* Shortest digits of positive finite 'bits' of a double that read
+ * back the same, closest to it on a tie, as digits * 10^exp
+ */
+static uint64_t jishortest(uint64_t bits, int* exp) {
+    uint64_t frac = bits & ((1ull << 52) - 1), c;
+    int biased = (int)(bits >> 52), q;
+    if (biased) {
+        c = frac | 1ull << 52; q = biased - 1075;
+        if (-52 <= q && q <= 0 && !(c & ((1ull << -q) - 1))) {
+            *exp = 0; return c >> -q;
+        }
+    } else { c = frac; q = -1074; }
+
+    bool even = !(c & 1), closer = !frac && biased > 1;
+    int k = jifloorshift(q * 1262611ll - (closer ? 524031 : 0), 22);
+    int h = q + jifloorshift(-k * 1741647ll, 19) + 1;
+    const uint64_t* g = jipow10sig[292 - k];
+    uint64_t lower = jiroundodd(g, (4 * c - 2 + closer) << h) + !even;
+    uint64_t upper = jiroundodd(g, (4 * c + 2) << h) - !even;
+    uint64_t vb = jiroundodd(g, 4 * c << h), s = vb / 4;
+
+    if (s >= 10) {
+        uint64_t sp = s / 10;
+        bool uin = lower <= 40 * sp, win = 40 * sp + 40 <= upper;
+        if (uin != win) { *exp = k + 1; return sp + win; }
+    }
+    bool uin = lower <= 4 * s, win = 4 * s + 4 <= upper;
+    *exp = k;
+    if (uin != win) return s + win;
+    return s + (vb > 4 * s + 2 || (vb == 4 * s + 2 && (s & 1)));
+}
+
+/* Shortest text that reads back the same, like %g without trailing
+ * zeros: plain from 1e-4 below 1e15, with ".0" if integral
+ */
+static void jiputnumber(jiwriter_t* w, double number) {
+    char text[40], digits[20], *cur = text;
+    uint64_t bits, mant; int exp, count = 0, point;
+    if (number != number || number - number != 0) {
+        jiput(w, "null", 4); return;
+    }
+    memcpy(&bits, &number, sizeof bits);
+    if (bits >> 63) *cur++ = '-';
+    if (!(bits & ~(1ull << 63))) {
+        memcpy(cur, "0.0", 3);
+        jiput(w, text, cur - text + 3); return;
+    }
+
+    mant = jishortest(bits & ~(1ull << 63), &exp);
+    for (; mant % 10 == 0; mant /= 10) ++exp;
+    for (; mant; mant /= 10) digits[sizeof digits - ++count] = '0' + mant % 10;
+    const char* first = digits + sizeof digits - count;
+    point = count + exp; // digits before the decimal point
+
+    if (-4 < point && point <= 15) {
+        if (point <= 0) {
+            memcpy(cur, "0.", 2); cur += 2;
+            memset(cur, '0', -point); cur += -point;
+            memcpy(cur, first, count); cur += count;
+        } else if (point >= count) {
+            memcpy(cur, first, count); cur += count;
+            memset(cur, '0', point - count); cur += point - count;
+            memcpy(cur, ".0", 2); cur += 2;
+        } else {
+            memcpy(cur, first, point); cur += point;
+            *cur++ = '.';
+            memcpy(cur, first + point, count - point); cur += count - point;
+        }
+    } else {
+        *cur++ = *first;
+        if (count > 1) {
+            *cur++ = '.';
+            memcpy(cur, first + 1, count - 1); cur += count - 1;
+        }
+        int mag = point > 0 ? point - 1 : 1 - point;
+        *cur++ = 'e';
+        *cur++ = point > 0 ? '+' : '-';
+        if (mag >= 100) *cur++ = '0' + mag / 100;
+        *cur++ = '0' + mag / 10 % 10;
+        *cur++ = '0' + mag % 10;
+    }
+    jiput(w, text, cur - text);
+}
+
+static void jiputvalue(jiwriter_t* w, jvalue_t* value, unsigned level) {
+    switch (value->type) {
+        case JT_NULL: jiput(w, "null", 4); break;
+        case JT_BOOLEAN:
+            if (value->as.boolean) jiput(w, "true", 4);
+            else jiput(w, "false", 5);
+            break;
+        case JT_INTEGER: case JT_NUMBER:
+            if (jiflags(value) & JI_INLINE) {
+                const char* text = (const char*)(value + 1);
+                jiput(w, text, strlen(text));
+            } else if (value->type == JT_INTEGER) jiputinteger(w, value->as.integer);
+            else jiputnumber(w, value->as.number);
+            break;
+        case JT_STRING: jiputstring(w, value->as.string); break;
+        case JT_ARRAY: {
+            jiputc(w, '[');
+            if (value->as.array.count == 0) { jiputc(w, ']'); break; }
+            if (w->pretty) jiputc(w, '\n');
+            for (size_t i = 0; i < value->as.array.count; i++) {
+                if (w->pretty) jiputindent(w, level + 1);
+                if (jiflags(value) & JI_PACKED_INTEGERS) jiputinteger(w, jintegers(value)[i]);
+                else if (jiflags(value) & JI_PACKED_NUMBERS) jiputnumber(w, jnumbers(value)[i]);
+                else jiputvalue(w, value->as.array.values[i], level + 1);
+                if (i < value->as.array.count - 1) jiputc(w, ',');
+                if (w->pretty) jiputc(w, '\n');
+            }
+            if (w->pretty) jiputindent(w, level);
+            jiputc(w, ']');
+        } break;
+        case JT_OBJECT: {
+            jiputc(w, '{');
+            if (value->as.object.count == 0) { jiputc(w, '}'); break; }
+            if (w->pretty) jiputc(w, '\n');
+            for (size_t i = 0; i < value->as.object.count; i++) {
+                jentry_t entry = value->as.object.entries[i];
+                if (w->pretty) jiputindent(w, level + 1);
+                jiputstring(w, entry.key);
+                if (w->pretty) jiput(w, ": ", 2);
+                else jiputc(w, ':');
+                jiputvalue(w, entry.value, level + 1);
+                if (i < value->as.object.count - 1) jiputc(w, ',');
+                if (w->pretty) jiputc(w, '\n');
+            }
+            if (w->pretty) jiputindent(w, level);
+            jiputc(w, '}');
+        } break;
+    }
+}
+
+/* Writes value and hands the rest of output to 'flush' */
+static bool jiwrite(jiwriter_t* w, jvalue_t* value, unsigned level) {
+    w->ok = true;
+    jiputvalue(w, value, level);
+    if (w->ok && w->flush && w->sb.len) w->ok = w->flush(w);
+    JC_FREE(w->sb.ptr);
+    return w->ok;
+}
+
+char* jwrite(jvalue_t* value, bool pretty, size_t* length) {
+    jiwriter_t w = {0};
+    if (!value) return NULL;
+    w.ok = true; w.pretty = pretty;
+    jiputvalue(&w, value, 0);
+    jiputc(&w, '\0');
+    if (!w.ok) { JC_FREE(w.sb.ptr); return NULL; }
+    if (length) *length = w.sb.len - 1;
+    return w.sb.ptr;
+}
+
+static bool jiflushfile(jiwriter_t* w) {
+    return fwrite(w->sb.ptr, 1, w->sb.len, w->dst) == w->sb.len;
+}
+
+#ifdef SINK_H
+static bool jiflushsink(jiwriter_t* w) {
+    return snk_write(w->dst, w->sb.ptr, w->sb.len);
+}
+
+bool jwrite_sink(jvalue_t* value, bool pretty, sink_t* sink) {
+    jiwriter_t w = {0};
+    if (!value || !sink) return false;
+    w.pretty = pretty;
+    w.flush = jiflushsink;
+    w.dst = sink;
+    return jiwrite(&w, value, 0);
+}
+#endif
+
+void (jprint)(jvalue_t* value, unsigned level) {
+    jiwriter_t w = {0};
+    if (!value) return;
+    w.pretty = true;
+    w.flush = jiflushfile;
+    w.dst = stdout;
+    (void)jiwrite(&w, value, level);
+}
+
+#define JI_CBOR_UINT   0
+#define JI_CBOR_NINT   1
+#define JI_CBOR_TEXT   3
+#define JI_CBOR_ARRAY  4
+#define JI_CBOR_MAP    5
+#define JI_CBOR_TAG    6
+#define JI_CBOR_SIMPLE 7
+
+/* Initial byte followed by 'size' bytes of 'arg' in big-endian */
+static void jicborfixed(jiwriter_t* w, int initial, uint64_t arg, size_t size) {
+    unsigned char head[9];
+    head[0] = (unsigned char)initial;
+    for (size_t i = size; i > 0; i--, arg >>= 8)
+        head[i] = arg & 0xFF;
+    jiput(w, head, size + 1);
+}
+
+static void jicborhead(jiwriter_t* w, int major, uint64_t arg) {
+    major <<= 5;
+    /**/ if (arg < 24)          jiputc(w, (char)(major | (int)arg));
+    else if (arg <= 0xFF)       jicborfixed(w, major | 24, arg, 1);
+    else if (arg <= 0xFFFF)     jicborfixed(w, major | 25, arg, 2);
+    else if (arg <= 0xFFFFFFFF) jicborfixed(w, major | 26, arg, 4);
+    else                        jicborfixed(w, major | 27, arg, 8);
+}
+
+/* Single precision is taken when it holds the number exactly */
+static void jicbornumber(jiwriter_t* w, double number) {
+    if (number >= -FLT_MAX && number <= FLT_MAX && (double)(float)number == number) {
+        float single = (float)number; uint32_t bits;
+        memcpy(&bits, &single, sizeof bits);
+        jicborfixed(w, JI_CBOR_SIMPLE << 5 | 26, bits, 4);
+    } else {
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof bits);
+        jicborfixed(w, JI_CBOR_SIMPLE << 5 | 27, bits, 8);
+    }
+}
+
+static void jicborinteger(jiwriter_t* w, long long integer) {
+    if (integer >= 0) jicborhead(w, JI_CBOR_UINT, (uint64_t)integer);
+    else jicborhead(w, JI_CBOR_NINT, (uint64_t)-(integer + 1));
+}
+
+static void jicborvalue(jiwriter_t* w, jvalue_t* value) {
+    switch (value->type) {
+        case JT_NULL: jiputc(w, (char)0xF6); break;
+        case JT_BOOLEAN: jiputc(w, (char)(value->as.boolean ? 0xF5 : 0xF4)); break;
+        case JT_INTEGER: jicborinteger(w, jinteger(value)); break;
+        case JT_NUMBER: jicbornumber(w, jnumber(value)); break;
+        case JT_STRING: {
+            size_t len = strlen(value->as.string);
+            jicborhead(w, JI_CBOR_TEXT, len);
+            jiput(w, value->as.string, len);
+        } break;
+        case JT_ARRAY: {
+            jicborhead(w, JI_CBOR_ARRAY, value->as.array.count);
+            for (size_t i = 0; i < value->as.array.count; i++)
+                if (jiflags(value) & JI_PACKED_INTEGERS) jicborinteger(w, jintegers(value)[i]);
+                else if (jiflags(value) & JI_PACKED_NUMBERS) jicbornumber(w, jnumbers(value)[i]);
+                else jicborvalue(w, value->as.array.values[i]);
+        } break;
+        case JT_OBJECT: {
+            jicborhead(w, JI_CBOR_MAP, value->as.object.count);
+            for (size_t i = 0; i < value->as.object.count; i++) {
+                jentry_t entry = value->as.object.entries[i];
+                size_t len = strlen(entry.key);
+                jicborhead(w, JI_CBOR_TEXT, len);
+                jiput(w, entry.key, len);
+                jicborvalue(w, entry.value);
+            }
+        } break;
+    }
+}
+
+unsigned char* jcbor_write(jvalue_t* value, size_t* length) {
+    jiwriter_t w = {0};
+    if (!value) return NULL;
+    w.ok = true;
+    jicborvalue(&w, value);
+    if (!w.ok) { JC_FREE(w.sb.ptr); return NULL; }
+    if (length) *length = w.sb.len;
+    return (unsigned char*)w.sb.ptr;
+}
+
+#ifdef SINK_H
+bool jcbor_write_sink(jvalue_t* value, sink_t* sink) {
+    jiwriter_t w = {0};
+    if (!value || !sink) return false;
+    w.ok = true;
+    w.flush = jiflushsink;
+    w.dst = sink;
+    jicborvalue(&w, value);
+    if (w.ok && w.sb.len) w.ok = w.flush(&w);
+    JC_FREE(w.sb.ptr);
+    return w.ok;
+}
+#endif
+
+static bool jicborread(jistate_t* st, void* dst, size_t size) {
+    unsigned char* out = dst;
+    while (size) {
+        if (st->cur >= st->end && jipeek(st) < 0) return false;
+        size_t part = st->end - st->cur;
+        if (part > size) part = size;
+        memcpy(out, st->cur, part);
+        out += part; st->cur += part;
+        size -= part;
+    }
+    return true;
+}
+
+/* Returns initial byte after tags and sets its argument,
+ * negative value on failure or indefinite length
+ */
+static int jicborgethead(jistate_t* st, uint64_t* arg) {
+    int initial;
+    do {
+        unsigned char bytes[8];
+        if ((initial = jinext(st)) < 0) return -1;
+        int info = initial & 31;
+        if (info < 24) { *arg = info; continue; }
+        if (info > 27) return -1;
+
+        size_t size = (size_t)1 << (info - 24);
+        if (!jicborread(st, bytes, size)) return -1;
+        *arg = 0;
+        for (size_t i = 0; i < size; i++)
+            *arg = *arg << 8 | bytes[i];
+    } while (initial >> 5 == JI_CBOR_TAG);
+    return initial;
+}
+
+/* Half precision widened through bits of single precision */
+static double jicborhalf(unsigned half) {
+    unsigned exp = half >> 10 & 31, mant = half & 1023;
+    uint32_t bits; float single;
+    if (exp == 0) return (half & 0x8000 ? -1.0 : 1.0) * mant / 16777216.0;
+    bits = (uint32_t)(half & 0x8000) << 16 | (uint32_t)mant << 13
+         | (uint32_t)(exp == 31 ? 255 : exp + 112) << 23;
+    memcpy(&single, &bits, sizeof single);
+    return single;
+}
+
+/* Flat input always holds at least a byte for each item */
+static bool jicborfits(jistate_t* st, uint64_t len) {
+    return st->fill ? len <= SIZE_MAX / 2 : len <= (uint64_t)(st->end - st->cur);
+}
+
+/* Stream text is gathered into 'sb' as it arrives, so length
+ * from the head is never allocated ahead of the bytes
+ */
+static bool jicborgather(jistate_t* st, uint64_t len) {
+    st->sb.len = 0;
+    while (len) {
+        if (st->cur >= st->end && jipeek(st) < 0) return false;
+        size_t part = st->end - st->cur;
+        if (part > len) part = (size_t)len;
+        if (!jipushrun(st->cur, part, &st->sb)) return false;
+        st->cur += part; len -= part;
+    }
+    return true;
+}
+
+static bool jicborkey(jistate_t* st, const char** strptr, uint64_t len) {
+    const char* run = (const char*)st->cur;
+    if (!jicborfits(st, len)) return false;
+    if (st->fill) {
+        if (!jicborgather(st, len)) return false;
+        run = st->sb.ptr;
+    } else st->cur += len;
+    if (st->arena) return (*strptr = jiintern(st->arena, run, len)) != NULL;
+
+    char* str = JC_MALLOC(len + 1);
+    if (!str) return false;
+    if (len) memcpy(str, run, len);
+    str[len] = '\0';
+    *strptr = str;
+    return true;
+}
+
+static jvalue_t* jicborparsevalue(jistate_t* st, unsigned depth) {
+    uint64_t arg; int initial;
+    size_t room = 0;
+    if (depth > JC_MAX_DEPTH) return NULL;
+    if ((initial = jicborgethead(st, &arg)) < 0) return NULL;
+
+    /* text is stored along with its node */
+    if (initial >> 5 == JI_CBOR_TEXT) {
+        if (!jicborfits(st, arg)) return NULL;
+        if (st->fill && !jicborgather(st, arg)) return NULL;
+        room = (size_t)arg + 1;
+    }
+    jvalue_t* value = jialloc(st, sizeof *value + room);
+    if (!value) return NULL;
+    memset(value, 0, sizeof *value);
+
+    switch (initial >> 5) {
+        case JI_CBOR_UINT: case JI_CBOR_NINT: {
+            if (arg > LLONG_MAX) goto error;
+            value->type = JT_INTEGER;
+            value->as.integer = initial >> 5 == JI_CBOR_UINT
+                ? (long long)arg : -(long long)arg - 1;
+        } break;
+        case JI_CBOR_TEXT: {
+            char* str = (char*)(value + 1);
+            if (st->fill) { if (arg) memcpy(str, st->sb.ptr, (size_t)arg); }
+            else if (!jicborread(st, str, (size_t)arg)) goto error;
+            str[arg] = '\0';
+            value->type = JT_STRING;
+            jisetflags(value, JI_INLINE);
+            value->as.string = str;
+        } break;
+        case JI_CBOR_ARRAY: {
+            value->type = JT_ARRAY;
+            if (!arg) break;
+            if (!jicborfits(st, arg)) goto error;
+
+            size_t base = st->stk.len;
+            for (; arg > 0; arg--) {
+                jvalue_t* element = jicborparsevalue(st, depth + 1);
+                if (!element) goto error_arr;
+                if (!jipushrun(&element, sizeof element, &st->stk)) {
+                    jidiscard(st, element); goto error_arr;
+                }
+            }
+
+            value->as.array.count = (st->stk.len - base) / sizeof(jvalue_t*);
+            value->as.array.values = jipopchildren(st, base, 0);
+            if (!value->as.array.values) goto error_arr;
+
+            break;
+        error_arr:
+            value->as.array.count = 0;
+            jidropchildren(st, base, JT_ARRAY);
+            goto error;
+        } break;
+        case JI_CBOR_MAP: {
+            value->type = JT_OBJECT;
+            if (!arg) break;
+            if (!jicborfits(st, arg)) goto error;
+
+            jentry_t entry; uint64_t len;
+            size_t base = st->stk.len;
+            for (; arg > 0; arg--) {
+                memset(&entry, 0, sizeof entry);
+                int head = jicborgethead(st, &len);
+                if (head < 0 || head >> 5 != JI_CBOR_TEXT) goto error_objs;
+                if (!jicborkey(st, &entry.key, len)) goto error_objs;
+                entry.value = jicborparsevalue(st, depth + 1);
+                if (!entry.value) goto error_obj;
+                if (!jipushrun(&entry, sizeof entry, &st->stk)) goto error_obj;
+            }
+
+            if (!jipopentries(st, value, base)) goto error_objs;
+
+            break;
+        error_obj:
+            if (!st->arena) JC_FREE((void*)entry.key);
+            jidiscard(st, entry.value);
+        error_objs:
+            value->as.object.count = 0;
+            jidropchildren(st, base, JT_OBJECT);
+            goto error;
+        } break;
+        case JI_CBOR_SIMPLE: {
+            switch (initial & 31) {
+                case 20: case 21: {
+                    value->type = JT_BOOLEAN;
+                    value->as.boolean = (initial & 31) == 21;
+                } break;
+                case 22: case 23: value->type = JT_NULL; break;
+                case 25: {
+                    value->type = JT_NUMBER;
+                    value->as.number = jicborhalf((unsigned)arg);
+                } break;
+                case 26: {
+                    uint32_t bits = (uint32_t)arg; float single;
+                    memcpy(&single, &bits, sizeof single);
+                    value->type = JT_NUMBER;
+                    value->as.number = single;
+                } break;
+                case 27: {
+                    value->type = JT_NUMBER;
+                    memcpy(&value->as.number, &arg, sizeof arg);
+                } break;
+                default: goto error;
+            }
+        } break;
+        default: goto error;
+    }
+
+    return value;
+error:
+    jidiscard(st, value);
+    return NULL;
+}
+
+static jvalue_t* jicborparse(jistate_t* st, jarena_t* arena) {
+    jiblock_t* top = arena ? arena->top : NULL;
+    char* begin = top ? top->begin : NULL;
+    size_t keycount = arena ? arena->keycount : 0;
+
+    st->arena = arena;
+    jvalue_t* json = jicborparsevalue(st, 0);
+    if (json && jipeek(st) >= 0) {
+        jidiscard(st, json);
+        json = NULL;
+    }
+    JC_FREE(st->sb.ptr);
+    JC_FREE(st->stk.ptr);
+
+    if (!json && arena) {
+        jiarenarewind(arena, top, begin);
+        if (arena->keycount != keycount) jiforgetkeys(arena);
+    }
+    return json;
+}
+
+jvalue_t* jcbor_parse(jarena_t* arena, const void* buf, size_t len) {
+    jistate_t st = {0};
+    if (!buf) return NULL;
+    st.cur = buf;
+    st.end = st.cur + len;
+    return jicborparse(&st, arena);
+}
+
+#ifdef STREAM_H
+static int jifillstream(jistate_t* st) {
+    size_t size = stm_read(st->src, st->buf, JC_RDR_BUF_SIZE);
+    st->cur = st->buf;
+    st->end = st->buf + size;
+    return size ? *st->cur : -1;
+}
+
+jvalue_t* jcbor_parse_stream(jarena_t* arena, stream_t* stream) {
+    unsigned char buf[JC_RDR_BUF_SIZE];
+    jistate_t st = {0};
+    if (!stream) return NULL;
+    st.fill = jifillstream;
+    st.buf = buf;
+    st.src = stream;
+    return jicborparse(&st, arena);
+}
+#endif
+
+void jfree(jvalue_t* value) {
+    if (!value) return;
+    switch (value->type) {
+        case JT_NULL: case JT_BOOLEAN:
+        case JT_INTEGER: case JT_NUMBER: break;
+
+        case JT_STRING:
+            if (!(jiflags(value) & JI_INLINE)) JC_FREE((void*)value->as.string);
+            break;
+        case JT_ARRAY: {
+            for (size_t i = 0; !jpacked(value) && i < value->as.array.count; i++)
                 jfree(value->as.array.values[i]);
-            free(value->as.array.values);
+            JC_FREE(value->as.array.values);
         } break;
         case JT_OBJECT: {
             for (size_t i = 0; i < value->as.object.count; i++) {
-                free((void*)value->as.object.entries[i].key);
+                JC_FREE((void*)value->as.object.entries[i].key);
                 jfree(value->as.object.entries[i].value);
             }
-            free(value->as.object.entries);
+            JC_FREE(value->as.object.entries);
         } break;
     }
-    free(value);
+    JC_FREE(value);
 }
 
 #endif /* JSON_IMPLEMENTATION */
\ No newline at end of file
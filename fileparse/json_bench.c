@@ -0,0 +1,338 @@
+/* Throughput of json.h entry points on generated input, built with
+ *     gcc -std=c11 -O2 -DNDEBUG fileparse/json_bench.c -o json_bench
+ * and run as
+ *     ./json_bench [--json] [megabytes per corpus] [repeats]
+ * Each corpus and entry point runs in its own process, so peak RSS
+ * read by getrusage belongs to it alone. Parse and free speeds are
+ * the best of the repeats, allocations are counted for one parse
+ * and jfree through the JC_MALLOC, JC_REALLOC and JC_FREE hooks.
+ * Rows of jwrite and jcbor_write serialize the tree of the corpus
+ * parsed once beforehand, their parse_mbps is the speed of writing
+ * it over the size of the JSON corpus, so it compares to the parse
+ * rows. Free speed is n/a where there is no tree to free: for them,
+ * jsax_buffer, jvalidate and the arena entries, which only reset
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+static size_t jb_mallocs, jb_reallocs, jb_frees;
+
+static void* jb_malloc(size_t size) {
+    ++jb_mallocs;
+    return malloc(size);
+}
+
+static void* jb_realloc(void* ptr, size_t size) {
+    ++jb_reallocs;
+    return realloc(ptr, size);
+}
+
+static void jb_free(void* ptr) {
+    jb_frees += ptr != NULL;
+    free(ptr);
+}
+
+#define JC_MALLOC  jb_malloc
+#define JC_REALLOC jb_realloc
+#define JC_FREE    jb_free
+
+#define JSON_IMPLEMENTATION
+#include "json.h"
+
+/* Growing text of the corpus */
+typedef struct jbtext {
+    char* data;
+    size_t len, cap;
+} jbtext_t;
+
+static void jb_put(jbtext_t* t, const char* str, size_t len) {
+    if (t->len + len + 1 > t->cap) {
+        while (t->len + len + 1 > t->cap) t->cap = t->cap ? t->cap * 2 : 4096;
+        if (!(t->data = realloc(t->data, t->cap))) { perror("realloc"); exit(1); }
+    }
+    memcpy(t->data + t->len, str, len);
+    t->data[t->len += len] = '\0';
+}
+
+static void jb_puts(jbtext_t* t, const char* str) {
+    jb_put(t, str, strlen(str));
+}
+
+static unsigned long long jb_seed = 88172645463325252ull;
+
+static unsigned long long jb_rand(void) {
+    jb_seed ^= jb_seed << 13;
+    jb_seed ^= jb_seed >> 7;
+    jb_seed ^= jb_seed << 17;
+    return jb_seed;
+}
+
+/* Arrays of integers and fractions of all magnitudes */
+static void jb_numbers(jbtext_t* t) {
+    char buf[64];
+    for (int i = 0; i < 16; i++) {
+        unsigned long long r = jb_rand();
+        switch (r % 4) {
+            case 0: sprintf(buf, "%lld", (long long)(r >> 8) - (1ll << 55)); break;
+            case 1: sprintf(buf, "%u", (unsigned)(r >> 40)); break;
+            case 2: sprintf(buf, "%.17g", (double)(r >> 11) / (1ull << 40)); break;
+            default: sprintf(buf, "%.6e", (double)(r >> 11) * 1e-3 * ((r & 8) ? 1e-40 : 1e40));
+        }
+        if (i) jb_puts(t, ", ");
+        jb_puts(t, buf);
+    }
+}
+
+/* Objects and arrays nested well below JC_MAX_DEPTH */
+static void jb_deep(jbtext_t* t) {
+    int depth = 100 + (int)(jb_rand() % 150);
+    for (int i = 0; i < depth; i++) jb_puts(t, i % 2 ? "[" : "{\"k\": ");
+    jb_puts(t, "true");
+    for (int i = depth; i-- > 0;) jb_puts(t, i % 2 ? "]" : "}");
+}
+
+/* Strings with simple, unicode and surrogate pair escapes */
+static void jb_strings(jbtext_t* t) {
+    static const char* parts[] = {
+        "plain text ", "\\\"quoted\\\" ", "tab\\there ", "line\\n",
+        "back\\\\slash ", "\\u00e9t\\u00e9 ", "\\ud83d\\ude00 ", "\\/path\\/ "
+    };
+    for (int i = 0; i < 8; i++) {
+        if (i) jb_puts(t, ", ");
+        jb_puts(t, "\"");
+        for (int j = 0; j < 12; j++) jb_puts(t, parts[jb_rand() % 8]);
+        jb_puts(t, "\"");
+    }
+}
+
+/* Objects with many distinct keys, past JC_HASH_MIN */
+static void jb_wide(jbtext_t* t) {
+    char buf[64];
+    jb_puts(t, "{");
+    for (int i = 0; i < 200; i++) {
+        sprintf(buf, "%s\"field_%d\": %u", i ? ", " : "", i, (unsigned)(jb_rand() % 1000));
+        jb_puts(t, buf);
+    }
+    jb_puts(t, "}");
+}
+
+typedef struct jbcorpus {
+    const char* name;
+    void (*item)(jbtext_t*);
+    bool wrap; // item is a list of values
+} jbcorpus_t;
+
+static const jbcorpus_t jb_corpora[] = {
+    { "numbers", jb_numbers, true  },
+    { "deep",    jb_deep,    false },
+    { "strings", jb_strings, true  },
+    { "wide",    jb_wide,    false },
+};
+
+static jbtext_t jb_generate(const jbcorpus_t* corpus, size_t size) {
+    jbtext_t t = {0};
+    jb_puts(&t, "[");
+    for (bool first = true; t.len < size; first = false) {
+        if (!first) jb_puts(&t, ",\n");
+        if (corpus->wrap) jb_puts(&t, "[");
+        corpus->item(&t);
+        if (corpus->wrap) jb_puts(&t, "]");
+    }
+    jb_puts(&t, "]");
+    return t;
+}
+
+typedef enum jbentry {
+    JB_CSTR, JB_BUFFER, JB_FILE, JB_ARENA, JB_INSITU,
+    JB_LAZY, JB_PACKED, JB_SAX, JB_VALIDATE,
+    JB_WRITE, JB_PRETTY, JB_CBOR, JB_COUNT
+} jbentry_t;
+
+static const char* jb_entries[JB_COUNT] = {
+    "jparse_cstr", "jparse_buffer", "jparse_file", "jparse_arena", "jparse_insitu",
+    "jparse_flags(lazy)", "jparse_flags(packed)", "jsax_buffer", "jvalidate",
+    "jwrite", "jwrite(pretty)", "jcbor_write"
+};
+
+static double jb_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static long jb_peak_kb(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+typedef struct jbresult {
+    double parse, free; // best seconds, negative if none
+    size_t mallocs, reallocs, frees;
+    long peak_kb, parse_kb;
+} jbresult_t;
+
+/* One parse of 'text' or write of its 'tree', and release of the
+ * result, timed apart
+ */
+static bool jb_once(jbentry_t entry, jbtext_t* text, const char* path, char* scratch,
+                    jarena_t* arena, jvalue_t* tree, double* parsetime, double* freetime) {
+    static const jhandler_t handler = {0};
+    jvalue_t* value = NULL;
+    void* output = NULL;
+    bool ok = true;
+    double start;
+
+    if (entry == JB_INSITU) memcpy(scratch, text->data, text->len);
+    start = jb_now();
+    switch (entry) {
+        case JB_CSTR:     value = jparse_cstr(text->data); break;
+        case JB_BUFFER:   value = jparse_buffer(text->data, text->len); break;
+        case JB_FILE:     value = jparse_file(path); break;
+        case JB_ARENA:    value = jparse_arena(arena, text->data, text->len); break;
+        case JB_INSITU:   value = jparse_insitu(arena, scratch, text->len); break;
+        case JB_LAZY:     value = jparse_flags(NULL, text->data, text->len, JF_LAZY_NUMBERS); break;
+        case JB_PACKED:   value = jparse_flags(NULL, text->data, text->len, JF_PACKED_ARRAYS); break;
+        case JB_SAX:      ok = jsax_buffer(text->data, text->len, &handler); break;
+        case JB_VALIDATE: ok = jvalidate(text->data, text->len, NULL); break;
+        case JB_WRITE:    output = jwrite(tree, false, NULL); break;
+        case JB_PRETTY:   output = jwrite(tree, true, NULL); break;
+        case JB_CBOR:     output = jcbor_write(tree, NULL); break;
+        default: break;
+    }
+    *parsetime = jb_now() - start;
+    *freetime = -1;
+    if (entry == JB_SAX || entry == JB_VALIDATE) return ok;
+    if (entry >= JB_WRITE) {
+        JC_FREE(output);
+        return output != NULL;
+    }
+    if (arena) {
+        jarena_reset(arena);
+        return value != NULL;
+    }
+
+    start = jb_now();
+    jfree(value);
+    *freetime = jb_now() - start;
+    return value != NULL;
+}
+
+static bool jb_measure(jbentry_t entry, jbtext_t* text, const char* path,
+                       int repeats, jbresult_t* res) {
+    bool inarena = entry == JB_ARENA || entry == JB_INSITU;
+    char* scratch = entry == JB_INSITU ? malloc(text->len + 1) : NULL;
+    jarena_t* arena = inarena ? jarena_init(1 << 20) : NULL;
+    jvalue_t* tree = entry >= JB_WRITE ? jparse_buffer(text->data, text->len) : NULL;
+    long base_kb = jb_peak_kb();
+    bool ok = entry < JB_WRITE || tree;
+
+    res->parse = res->free = -1;
+    for (int r = 0; r < repeats && ok; r++) {
+        double parsetime, freetime;
+        jb_mallocs = jb_reallocs = jb_frees = 0;
+        ok = jb_once(entry, text, path, scratch, arena, tree, &parsetime, &freetime);
+        if (res->parse < 0 || parsetime < res->parse) res->parse = parsetime;
+        if (freetime >= 0 && (res->free < 0 || freetime < res->free)) res->free = freetime;
+    }
+    res->mallocs = jb_mallocs;
+    res->reallocs = jb_reallocs;
+    res->frees = jb_frees;
+    res->peak_kb = jb_peak_kb();
+    res->parse_kb = res->peak_kb - base_kb;
+
+    if (arena) jarena_free(arena);
+    jfree(tree);
+    free(scratch);
+    return ok;
+}
+
+static void jb_speed(bool json, size_t bytes, double seconds) {
+    if (seconds < 0) fputs(json ? "null" : "n/a", stdout);
+    else printf("%.1f", seconds > 0 ? bytes / 1e6 / seconds : 0.0);
+}
+
+static void jb_print(bool json, bool first, const char* corpus, const char* entry,
+                     size_t bytes, bool ok, const jbresult_t* res) {
+    if (!json) {
+        printf("%s,%s,%zu,%s,", corpus, entry, bytes, ok ? "ok" : "failed");
+        jb_speed(json, bytes, res->parse); putchar(',');
+        jb_speed(json, bytes, res->free);
+        printf(",%zu,%zu,%zu,%ld,%ld\n", res->mallocs, res->reallocs,
+               res->frees, res->peak_kb, res->parse_kb);
+        return;
+    }
+    printf("%s\n  {\"corpus\": \"%s\", \"entry\": \"%s\", \"bytes\": %zu, \"ok\": %s, \"parse_mbps\": ",
+           first ? "" : ",", corpus, entry, bytes, ok ? "true" : "false");
+    jb_speed(json, bytes, res->parse);
+    fputs(", \"free_mbps\": ", stdout);
+    jb_speed(json, bytes, res->free);
+    printf(", \"mallocs\": %zu, \"reallocs\": %zu, \"frees\": %zu, \"peak_rss_kb\": %ld, \"parse_rss_kb\": %ld}",
+           res->mallocs, res->reallocs, res->frees, res->peak_kb, res->parse_kb);
+}
+
+/* Child generates the corpus itself, so parent stays small and
+ * does not lift peak RSS of children it forks
+ */
+static int jb_child(const jbcorpus_t* corpus, jbentry_t entry, size_t size,
+                    int repeats, bool json, bool first) {
+    char path[] = "/tmp/json_bench_XXXXXX";
+    jbtext_t text = jb_generate(corpus, size);
+    jbresult_t res = {0};
+    bool ok;
+
+    if (entry == JB_FILE) {
+        int fd = mkstemp(path);
+        FILE* file = fd < 0 ? NULL : fdopen(fd, "wb");
+        if (!file || fwrite(text.data, 1, text.len, file) != text.len) {
+            perror(path); return 1;
+        }
+        fclose(file);
+    }
+    ok = jb_measure(entry, &text, path, repeats, &res);
+    if (entry == JB_FILE) unlink(path);
+
+    jb_print(json, first, corpus->name, jb_entries[entry], text.len, ok, &res);
+    free(text.data);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    bool json = argc > 1 && !strcmp(argv[1], "--json");
+    size_t megabytes = argc > 1 + json ? strtoul(argv[1 + json], NULL, 10) : 16;
+    int repeats = argc > 2 + json ? atoi(argv[2 + json]) : 3;
+    int status = 0;
+
+    if (!megabytes || repeats <= 0) {
+        fprintf(stderr, "usage: %s [--json] [megabytes per corpus] [repeats]\n", argv[0]);
+        return 2;
+    }
+    if (json) fputs("[", stdout);
+    else puts("corpus,entry,bytes,status,parse_mbps,free_mbps,mallocs,reallocs,frees,peak_rss_kb,parse_rss_kb");
+
+    bool first = true;
+    for (size_t c = 0; c < sizeof jb_corpora / sizeof *jb_corpora; c++)
+        for (int e = 0; e < JB_COUNT; e++, first = false) {
+            int result;
+            fflush(stdout);
+            pid_t pid = fork();
+            if (pid < 0) { perror("fork"); return 1; }
+            if (pid == 0) {
+                result = jb_child(&jb_corpora[c], (jbentry_t)e, megabytes << 20, repeats, json, first);
+                fflush(stdout);
+                _exit(result);
+            }
+            if (waitpid(pid, &result, 0) < 0 || !WIFEXITED(result) || WEXITSTATUS(result))
+                status = 1;
+        }
+    if (json) puts("\n]");
+    return status;
+}
\ No newline at end of file
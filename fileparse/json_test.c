@@ -0,0 +1,205 @@
+/* Checks of json.h that are easy to get wrong, built with
+ *     gcc -std=c11 -Wall -Wextra -Wno-missing-field-initializers \
+ *         -g -fsanitize=address,undefined \
+ *         fileparse/json_test.c -o json_test && ./json_test
+ * Allocations go through counting hooks, so tests also check
+ * the largest block ever asked for
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t jt_largest;
+
+static void* jt_malloc(size_t size) {
+    if (size > jt_largest) jt_largest = size;
+    return malloc(size);
+}
+
+static void* jt_realloc(void* ptr, size_t size) {
+    if (size > jt_largest) jt_largest = size;
+    return realloc(ptr, size);
+}
+
+#define JC_MALLOC  jt_malloc
+#define JC_REALLOC jt_realloc
+#define JC_FREE    free
+
+#define STREAM_IMPLEMENTATION
+#include "../memory/stream.h"
+#define JSON_IMPLEMENTATION
+#include "json.h"
+
+static jvalue_t* jt_cbor_stream(jarena_t* arena, const void* buf, size_t len) {
+    stream_t* stm = stm_init_buffer(buf, len);
+    jvalue_t* value = jcbor_parse_stream(arena, stm);
+    stm_destroy(stm);
+    return value;
+}
+
+/* Huge text length in a short stream must fail at its end */
+static void test_cbor_huge_length(void) {
+    static const unsigned char text[] = { 0x7B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 'a', 'b' };
+    static const unsigned char key [] = { 0xA1, 0x7B, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 'k' };
+    static const unsigned char arr [] = { 0x9B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    static const unsigned char ok  [] = { 0xA1, 0x61, 'k', 0x63, 'a', 'b', 'c' };
+    jarena_t* arena = jarena_init(4096);
+
+    for (int inarena = 0; inarena < 2; inarena++) {
+        jarena_t* a = inarena ? arena : NULL;
+        jt_largest = 0;
+        assert(!jt_cbor_stream(a, text, sizeof text));
+        assert(!jt_cbor_stream(a, key, sizeof key));
+        assert(!jt_cbor_stream(a, arr, sizeof arr));
+        assert(!jcbor_parse(a, text, sizeof text));
+        assert(!jcbor_parse(a, key, sizeof key));
+        assert(jt_largest <= 65536);
+
+        jvalue_t* value = jt_cbor_stream(a, ok, sizeof ok);
+        assert(value && !strcmp(jat(value, "k")->as.string, "abc"));
+        if (!a) jfree(value);
+    }
+    jarena_free(arena);
+}
+
+static void jt_expect_write(jvalue_t* value, const char* text) {
+    char* out = jwrite(value, false, NULL);
+    assert(out && !strcmp(out, text));
+    free(out);
+}
+
+/* Only arrays of one numeric type are packed, integers mixed with
+ * fractions stay nodes and are written back as they were
+ */
+static void test_packed_mixed(void) {
+    jvalue_t* value = jparse_flags(NULL, "[0, 0.5, 1]", 11, JF_PACKED_ARRAYS);
+    assert(jpacked(value) == JT_NULL && value->as.array.count == 3);
+    assert(jpath(value, 0)->type == JT_INTEGER && jpath(value, 1)->type == JT_NUMBER);
+    assert(jpath(value, 2)->type == JT_INTEGER && jpath(value, 2)->as.integer == 1);
+    jt_expect_write(value, "[0,0.5,1]");
+    jfree(value);
+
+    value = jparse_flags(NULL, "[1e2, 3, -4]", 12, JF_PACKED_ARRAYS);
+    assert(jpacked(value) == JT_NULL && jpath(value, 1)->as.integer == 3);
+    jt_expect_write(value, "[100.0,3,-4]");
+    jfree(value);
+
+    value = jparse_flags(NULL, "[1, 2, 9007199254740993, 0.5]", 29, JF_PACKED_ARRAYS);
+    assert(jpacked(value) == JT_NULL);
+    assert(jpath(value, 2)->as.integer == 9007199254740993ll);
+    jt_expect_write(value, "[1,2,9007199254740993,0.5]");
+    jfree(value);
+
+    value = jparse_flags(NULL, "[1, 0.5, 2, \"x\"]", 16, JF_PACKED_ARRAYS);
+    assert(jpacked(value) == JT_NULL);
+    jt_expect_write(value, "[1,0.5,2,\"x\"]");
+    jfree(value);
+
+    value = jparse_flags(NULL, "[1, 2, 3]", 9, JF_PACKED_ARRAYS);
+    assert(jpacked(value) == JT_INTEGER && jintegers(value)[2] == 3);
+    jfree(value);
+
+    value = jparse_flags(NULL, "[0.5, 1e2]", 10, JF_PACKED_ARRAYS);
+    assert(jpacked(value) == JT_NUMBER && jnumbers(value)[1] == 100);
+    jfree(value);
+}
+
+/* jvalidate agrees with the parser, ranges of numbers too */
+static void test_validate_ranges(void) {
+    static const char* inputs[] = {
+        "4e831", "1e999", "-1e999", "1e-999", "[1, 2e400]", "{\"a\": 1e308}",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+        "-9223372036854775809", "[0.1, 123456789012345678901234567890]", "1.7976931348623157e308"
+    };
+    for (size_t i = 0; i < sizeof inputs / sizeof *inputs; i++) {
+        size_t len = strlen(inputs[i]), offset = len;
+        jvalue_t* value = jparse_buffer(inputs[i], len);
+        assert(jvalidate(inputs[i], len, &offset) == (value != NULL));
+        assert(value || offset < len);
+        jfree(value);
+    }
+}
+
+/* Doubles are written by shortest digits that read back the same */
+static void test_write_shortest(void) {
+    static const struct { double number; const char* text; } cases[] = {
+        { 0.1, "0.1" }, { 0.3, "0.3" }, { 0.1 + 0.2, "0.30000000000000004" },
+        { 1.0 / 3, "0.3333333333333333" }, { 100, "100.0" }, { -0.0, "-0.0" },
+        { 1e23, "1e+23" }, { 1e-5, "1e-05" }, { 0.0001, "0.0001" },
+        { 5e-324, "5e-324" }, { -1e-323, "-1e-323" }, { 2.2250738585072009e-308, "2.225073858507201e-308" },
+        { 2.2250738585072014e-308, "2.2250738585072014e-308" }, { 1.7976931348623157e308, "1.7976931348623157e+308" }
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof *cases; i++) {
+        jvalue_t value = { JT_NUMBER, { .number = cases[i].number } };
+        jt_expect_write(&value, cases[i].text);
+    }
+
+    /* subnormals and neighbours of powers of two read back */
+    for (unsigned long long bits = 1; bits < (1ull << 63); bits = bits * 3 + 1) {
+        unsigned long long near[] = { bits, bits - 1, bits + 1 };
+        for (int i = 0; i < 3; i++) {
+            jvalue_t value = { JT_NUMBER };
+            memcpy(&value.as.number, &near[i], sizeof value.as.number);
+            if (value.as.number != value.as.number || value.as.number - value.as.number != 0) continue;
+            char* out = jwrite(&value, false, NULL);
+            assert(out && strtod(out, NULL) == value.as.number);
+            free(out);
+        }
+    }
+}
+
+/* Values built by hand with positional initializers, large
+ * object has no room for hash index and is scanned
+ */
+static void test_hand_built(void) {
+    static char keys[JC_HASH_MIN + 4][8];
+    jentry_t entries[JC_HASH_MIN + 4];
+    jvalue_t one = { JT_INTEGER, { .integer = 1 } };
+    jvalue_t* values[] = { &one };
+    jvalue_t array = { JT_ARRAY, { .array = { values, 1 } } };
+
+    for (size_t i = 0; i < JC_HASH_MIN + 4; i++) {
+        sprintf(keys[i], "k%zu", i);
+        entries[i].key = keys[i];
+        entries[i].value = &array;
+    }
+    jvalue_t object = { JT_OBJECT, { .object = { entries, JC_HASH_MIN + 4 } } };
+    assert(jat(&object, "k19") == &array && !jat(&object, "k99"));
+    assert(jpath(&object, "k3", 0) == &one);
+    jt_expect_write(&array, "[1]");
+}
+
+/* Lookups agree with and without hash index of JF_HASHED_OBJECTS */
+static void test_hashed_objects(void) {
+    char text[JC_HASH_MIN * 2 * 12 + 2] = "{", *cur = text + 1;
+    for (int i = 0; i < JC_HASH_MIN * 2; i++)
+        cur += sprintf(cur, "%s\"k%d\":%d", i ? "," : "", i, i);
+    strcpy(cur, "}");
+
+    for (int hashed = 0; hashed < 2; hashed++) {
+        jvalue_t* value = jparse_flags(NULL, text, strlen(text), hashed ? JF_HASHED_OBJECTS : 0);
+        assert(value && value->as.object.count == JC_HASH_MIN * 2);
+        for (int i = 0; i < JC_HASH_MIN * 2; i++) {
+            char key[8];
+            sprintf(key, "k%d", i);
+            assert(jat(value, key)->as.integer == i);
+        }
+        assert(!jat(value, "k99") && !jat(value, ""));
+        jt_expect_write(jpath(value, "k3"), "3");
+        jfree(value);
+    }
+}
+
+int main(void) {
+    test_cbor_huge_length();
+    test_packed_mixed();
+    test_validate_ranges();
+    test_write_shortest();
+    test_hand_built();
+    test_hashed_objects();
+    puts("ok");
+    return 0;
+}
\ No newline at end of file
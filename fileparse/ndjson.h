@@ -0,0 +1,268 @@
+#ifndef NEWLINE_DELIMITED_JSON_H
+#define NEWLINE_DELIMITED_JSON_H
+
+#include "json.h"
+
+#define NDC_CHUNK_SIZE  262144
+#define NDC_MAX_THREADS 64
+
+/* Gets trees of input lines in order, 'value' is NULL for invalid
+ * line, 'line' counts from 1 and blank lines are skipped. The tree
+ * lives in arena that is reset after the callback, false stops
+ */
+typedef bool (*ndcallback_t)(jvalue_t* value, size_t line, void* ctx);
+
+/* Input is split into line-aligned chunks parsed by 'threads'
+ * workers, one per core if 0. Returns false if callback stopped
+ * reading or on failure
+ */
+bool ndparse(const char* buffer, size_t length, unsigned threads, ndcallback_t callback, void* ctx);
+bool ndparse_file(const char* filename, unsigned threads, ndcallback_t callback, void* ctx);
+
+#endif /* NEWLINE_DELIMITED_JSON_H */
+
+#ifdef NDJSON_IMPLEMENTATION
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct ndiresult {
+    jvalue_t* value;
+    size_t line; // within chunk
+} ndiresult_t;
+
+typedef struct ndislot {
+    const char *begin, *end;
+    char* buf; size_t cap; // chunk read from file
+    jarena_t* arena;
+    ndiresult_t* results;
+    size_t count, rescap, lines;
+    bool done, failed;
+} ndislot_t;
+
+/* Main thread fills slots and hands them out in order, workers
+ * take them in the same order, slot of 'filled % nslots' is free
+ */
+typedef struct ndistate ndistate_t;
+struct ndistate {
+    pthread_mutex_t lock;
+    pthread_cond_t queued, parsed;
+    ndislot_t* slots; size_t nslots;
+    size_t filled, taken; bool stop;
+
+    bool (*fill)(ndistate_t*, ndislot_t*);
+    const char *cur, *end; // rest of buffer
+    FILE* file; char* carry; size_t carrylen, carrycap;
+    bool failed;
+};
+
+static bool ndiblank(const char* cur, const char* end) {
+    for (; cur < end; ++cur)
+        if (*cur != ' ' && *cur != '\t' && *cur != '\r') return false;
+    return true;
+}
+
+static void ndiparsechunk(ndislot_t* slot) {
+    const char* cur = slot->begin;
+    size_t line = 0;
+    slot->count = 0;
+    slot->failed = false;
+
+    while (cur < slot->end) {
+        const char* nl = memchr(cur, '\n', slot->end - cur);
+        const char* eol = nl ? nl : slot->end;
+        ++line;
+
+        if (!ndiblank(cur, eol)) {
+            if (slot->count == slot->rescap) {
+                size_t cap = slot->rescap ? slot->rescap * 2 : 64;
+                void* new = JC_REALLOC(slot->results, cap * sizeof *slot->results);
+                if (!new) { slot->failed = true; break; }
+                slot->results = new;
+                slot->rescap = cap;
+            }
+            slot->results[slot->count].value = jparse_arena(slot->arena, cur, eol - cur);
+            slot->results[slot->count].line = line;
+            slot->count++;
+        }
+        cur = nl ? nl + 1 : slot->end;
+    }
+    slot->lines = line;
+}
+
+static void* ndiworker(void* arg) {
+    ndistate_t* st = arg;
+    pthread_mutex_lock(&st->lock);
+    while (true) {
+        while (!st->stop && st->taken == st->filled)
+            pthread_cond_wait(&st->queued, &st->lock);
+        if (st->stop) break;
+
+        ndislot_t* slot = &st->slots[st->taken++ % st->nslots];
+        pthread_mutex_unlock(&st->lock);
+        ndiparsechunk(slot);
+        pthread_mutex_lock(&st->lock);
+        slot->done = true;
+        pthread_cond_broadcast(&st->parsed);
+    }
+    pthread_mutex_unlock(&st->lock);
+    return NULL;
+}
+
+static bool ndifillbuffer(ndistate_t* st, ndislot_t* slot) {
+    if (st->cur >= st->end) return false;
+    const char* cut = st->end;
+    if ((size_t)(st->end - st->cur) > NDC_CHUNK_SIZE) {
+        const char* from = st->cur + NDC_CHUNK_SIZE;
+        const char* nl = memchr(from, '\n', st->end - from);
+        if (nl) cut = nl + 1;
+    }
+    slot->begin = st->cur;
+    slot->end = cut;
+    st->cur = cut;
+    return true;
+}
+
+static bool ndireserve(char** buf, size_t* cap, size_t require) {
+    if (require <= *cap) return true;
+    size_t newcap = *cap ? *cap : NDC_CHUNK_SIZE;
+    while (newcap < require) newcap *= 2;
+    void* new = JC_REALLOC(*buf, newcap);
+    if (!new) return false;
+    *buf = new;
+    *cap = newcap;
+    return true;
+}
+
+/* Reads after the rest of previous chunk up to its last newline,
+ * a line longer than chunk is read whole
+ */
+static bool ndifillfile(ndistate_t* st, ndislot_t* slot) {
+    size_t len = st->carrylen, cut = 0;
+    if (!ndireserve(&slot->buf, &slot->cap, len + NDC_CHUNK_SIZE)) goto error;
+    if (len) memcpy(slot->buf, st->carry, len);
+
+    while (true) {
+        size_t got = fread(slot->buf + len, 1, slot->cap - len, st->file);
+        if (!got) {
+            if (ferror(st->file)) goto error;
+            cut = len; break;
+        }
+        for (size_t i = len + got; i > len; i--)
+            if (slot->buf[i - 1] == '\n') { cut = i; break; }
+        len += got;
+        if (cut) break;
+        if (len == slot->cap && !ndireserve(&slot->buf, &slot->cap, len * 2)) goto error;
+    }
+    if (!len) return false;
+
+    st->carrylen = len - cut;
+    if (!ndireserve(&st->carry, &st->carrycap, st->carrylen)) goto error;
+    memcpy(st->carry, slot->buf + cut, st->carrylen);
+    slot->begin = slot->buf;
+    slot->end = slot->buf + cut;
+    return true;
+error:
+    st->failed = true;
+    return false;
+}
+
+static bool ndirun(ndistate_t* st, unsigned threads, ndcallback_t callback, void* ctx) {
+    pthread_t workers[NDC_MAX_THREADS];
+    size_t started = 0, delivered = 0, line = 1;
+    bool ok = false, more = true;
+
+    if (!threads) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (unsigned)cores : 1;
+    }
+    if (threads > NDC_MAX_THREADS) threads = NDC_MAX_THREADS;
+
+    st->nslots = threads * 2;
+    st->slots = JC_MALLOC(st->nslots * sizeof *st->slots);
+    if (!st->slots) return false;
+    memset(st->slots, 0, st->nslots * sizeof *st->slots);
+    for (size_t i = 0; i < st->nslots; i++)
+        if (!(st->slots[i].arena = jarena_init(NDC_CHUNK_SIZE * 4))) goto cleanup;
+
+    pthread_mutex_init(&st->lock, NULL);
+    pthread_cond_init(&st->queued, NULL);
+    pthread_cond_init(&st->parsed, NULL);
+    for (; started < threads; started++)
+        if (pthread_create(&workers[started], NULL, ndiworker, st)) break;
+
+    ok = started > 0;
+    pthread_mutex_lock(&st->lock);
+    while (ok) {
+        while (more && st->filled - delivered < st->nslots) {
+            ndislot_t* slot = &st->slots[st->filled % st->nslots];
+            pthread_mutex_unlock(&st->lock);
+            more = st->fill(st, slot);
+            pthread_mutex_lock(&st->lock);
+            if (!more) break;
+            slot->done = false;
+            st->filled++;
+            pthread_cond_signal(&st->queued);
+        }
+        if (delivered == st->filled) break;
+
+        ndislot_t* slot = &st->slots[delivered % st->nslots];
+        while (!slot->done) pthread_cond_wait(&st->parsed, &st->lock);
+        pthread_mutex_unlock(&st->lock);
+
+        ok = !slot->failed;
+        for (size_t i = 0; ok && i < slot->count; i++)
+            ok = callback(slot->results[i].value, line + slot->results[i].line - 1, ctx);
+        line += slot->lines;
+        jarena_reset(slot->arena);
+
+        pthread_mutex_lock(&st->lock);
+        delivered++;
+    }
+    st->stop = true;
+    pthread_cond_broadcast(&st->queued);
+    pthread_mutex_unlock(&st->lock);
+
+    for (size_t i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+    pthread_cond_destroy(&st->parsed);
+    pthread_cond_destroy(&st->queued);
+    pthread_mutex_destroy(&st->lock);
+    ok = ok && !st->failed;
+
+cleanup:
+    for (size_t i = 0; i < st->nslots; i++) {
+        jarena_free(st->slots[i].arena);
+        JC_FREE(st->slots[i].results);
+        JC_FREE(st->slots[i].buf);
+    }
+    JC_FREE(st->slots);
+    return ok;
+}
+
+bool ndparse(const char* buf, size_t len, unsigned threads, ndcallback_t callback, void* ctx) {
+    ndistate_t st = {0};
+    if (!buf || !callback) return false;
+    st.fill = ndifillbuffer;
+    st.cur = buf;
+    st.end = buf + len;
+    return ndirun(&st, threads, callback, ctx);
+}
+
+bool ndparse_file(const char* filename, unsigned threads, ndcallback_t callback, void* ctx) {
+    ndistate_t st = {0};
+    if (!callback) return false;
+    FILE* fd = fopen(filename, "rb");
+    if (!fd) return false;
+    st.fill = ndifillfile;
+    st.file = fd;
+    bool ok = ndirun(&st, threads, callback, ctx);
+    JC_FREE(st.carry);
+    fclose(fd);
+    return ok;
+}
+
+#endif /* NDJSON_IMPLEMENTATION */
\ No newline at end of file